@@ -0,0 +1,136 @@
+#pragma once
+
+#include "ProcMaps.h"  // Headers do projeto
+#include "TraceSink.h" // Headers do projeto
+
+#include <cstddef> // Utilizado pelo tipo size_t
+#include <cstdint> // Utilizado pelos endereços e tamanhos
+#include <fstream> // Utilizado pelo arquivo da série temporal
+#include <map>     // Utilizado pelos mapas de intervalos e estados por processo
+#include <string>  // Utilizado pelos nomes dos locais de chamada
+#include <utility> // Utilizado pelo std::pair das chaves do cache de locais
+#include <vector>  // Utilizado pela classificação por número de syscall e pelos locais
+
+/**
+ * @class AddressSpaceProfiler
+ * @brief Acompanha o crescimento do espaço de endereçamento de cada processo rastreado.
+ *
+ * Mantém, por processo, um mapa de intervalos dos mapeamentos, semeado a partir do
+ * /proc/[pid]/maps e atualizado pelos resultados de mmap, munmap, mremap e brk (e refeito a cada
+ * exec). Cada intervalo lembra se é anônimo ou de arquivo e qual local de chamada o criou, então
+ * o que ainda está mapeado ao final aponta para os locais que mais cresceram.
+ *
+ * Grava uma série temporal em CSV com a memória virtual anônima e de arquivo de cada processo, e
+ * os bytes devolvidos com madvise(MADV_DONTNEED), que indicam rotatividade do alocador. Ao final
+ * registra um resumo por processo e os locais de maior crescimento.
+ */
+class AddressSpaceProfiler : public TraceSink
+{
+  public:
+    /**
+     * @brief Abre o arquivo da série temporal e escreve o cabeçalho.
+     * @param path O caminho do arquivo CSV.
+     */
+    explicit AddressSpaceProfiler(const std::string &path);
+
+    /// @brief Pede só o evento cru das syscalls que alteram o espaço de endereçamento e
+    /// dispensa as demais.
+    CaptureLevel on_syscall_entry(const SyscallEvent &event) override;
+
+    void on_syscall_exit(const SyscallEvent &event) override;
+    void on_process_event(const ProcessEvent &event) override;
+
+    /// @brief Escreve as últimas amostras e registra o relatório no log.
+    void on_finish() override;
+
+  private:
+    /// @brief As syscalls que alteram o espaço de endereçamento.
+    enum class Kind
+    {
+        None,
+        Mmap,
+        Munmap,
+        Mremap,
+        Brk,
+        Madvise
+    };
+
+    /// @brief Um intervalo mapeado [início, end).
+    struct Region
+    {
+        std::uint64_t end = 0;
+        bool anonymous = true;
+        /// @brief Índice em m_sites do local que criou o intervalo; -1 se já existia.
+        int site = -1;
+    };
+
+    /// @brief Crescimento acumulado de um local de chamada ("syscall módulo+deslocamento").
+    struct Site
+    {
+        std::string name;
+        std::size_t calls = 0;
+        std::uint64_t grown = 0;
+        std::uint64_t released = 0;
+    };
+
+    /// @brief O espaço de endereçamento de um processo.
+    struct ProcessState
+    {
+        /// @brief Intervalos indexados pelo endereço inicial, sem sobreposição.
+        std::map<std::uint64_t, Region> regions;
+        /// @brief O fim atual do heap do brk; zero enquanto for desconhecido.
+        std::uint64_t brk = 0;
+        std::uint64_t anonymous = 0;
+        std::uint64_t file = 0;
+        std::uint64_t peak = 0;
+        std::uint64_t dontneed = 0;
+        /// @brief Local de chamada já resolvido por (syscall, endereço da instrução).
+        std::map<std::pair<long, std::uint64_t>, int> sites;
+        std::uint64_t last_sample_ns = 0;
+        /// @brief Verdadeiro se os totais mudaram desde a última amostra gravada.
+        bool dirty = false;
+    };
+
+    /// @brief Retorna o estado do processo, semeando-o do /proc/[pid]/maps na primeira vez.
+    ProcessState &process(pid_t pid);
+
+    /// @brief Lê os mapeamentos atuais de um processo.
+    void load(pid_t pid, ProcessState &state);
+
+    /// @brief Retorna o intervalo que contém o endereço, ou nullptr.
+    static const Region *find(const ProcessState &state, std::uint64_t addr);
+
+    /// @brief Retorna o índice do local de chamada do evento, criando-o se preciso.
+    int site_of(ProcessState &state, const SyscallEvent &event);
+
+    /**
+     * @brief Remove o intervalo [start, end), dividindo os mapeamentos nas bordas.
+     * @param account Se verdadeiro, os bytes removidos contam como liberados pelo local que os
+     * criou.
+     */
+    void unmap(ProcessState &state, std::uint64_t start, std::uint64_t end, bool account);
+
+    /**
+     * @brief Mapeia o intervalo [start, end), substituindo o que houver nele.
+     * @param site O local que criou o intervalo.
+     * @param account Se verdadeiro, os bytes mapeados contam como crescimento do local.
+     */
+    void map(ProcessState &state, std::uint64_t start, std::uint64_t end, bool anonymous,
+             int site, bool account);
+
+    /// @brief Grava uma amostra do processo se os totais mudaram e o intervalo já passou.
+    void sample(pid_t pid, ProcessState &state, std::uint64_t now_ns, bool force);
+
+    /// @brief Registra o resumo de um processo no log.
+    void report(pid_t pid, const ProcessState &state) const;
+
+    std::vector<Kind> m_kind_by_nr;
+    std::map<pid_t, ProcessState> m_processes;
+    std::vector<Site> m_sites;
+    std::map<std::string, int> m_site_index;
+    std::uint64_t m_page_mask;
+    std::uint64_t m_origin_ns = 0;
+    std::uint64_t m_last_ns = 0;
+    std::ofstream m_file;
+    ProcMaps m_maps;
+};
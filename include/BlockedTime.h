@@ -0,0 +1,99 @@
+#pragma once
+
+#include "TraceSink.h" // Headers do projeto
+
+#include <array>   // Utilizado para os acumuladores por classe de syscall
+#include <cstddef> // Utilizado pelo tipo size_t
+#include <map>     // Utilizado para as estatísticas por thread e a linha do tempo
+#include <vector>  // Utilizado para o heap das chamadas bloqueantes mais longas
+
+/**
+ * @brief Classes de chamadas de sistema em que uma thread normalmente fica bloqueada.
+ */
+enum class BlockClass
+{
+    Io,
+    Futex,
+    Poll,
+    Sleep,
+    Network,
+    Count ///< Quantidade de classes, não é uma classe válida.
+};
+
+/**
+ * @class BlockedTimeProfiler
+ * @brief Mede quanto tempo de parede cada thread passa bloqueada em cada classe de syscall.
+ *
+ * Usa os intervalos entre as paradas de entrada e saída que o Tracer já observa. Ao final do
+ * rastreamento registra um resumo por thread, uma linha do tempo por thread (em intervalos de um
+ * segundo) e as N chamadas bloqueantes mais longas com seus argumentos.
+ */
+class BlockedTimeProfiler : public TraceSink
+{
+  public:
+    /**
+     * @brief Constrói o profiler.
+     * @param top_n Quantidade de chamadas bloqueantes mais longas mantidas para o relatório.
+     */
+    explicit BlockedTimeProfiler(std::size_t top_n);
+
+    /// @brief Marca a origem da linha do tempo; só as chamadas bloqueantes têm os argumentos
+    /// formatados, para o ranking das mais longas.
+    CaptureLevel on_syscall_entry(const SyscallEvent &event) override;
+
+    void on_syscall_exit(const SyscallEvent &event) override;
+
+    /// @brief Registra o relatório completo no log.
+    void on_finish() override;
+
+  private:
+    static constexpr std::size_t kClassCount = static_cast<std::size_t>(BlockClass::Count);
+
+    /// @brief Nanossegundos bloqueados em cada classe.
+    using ClassTimes = std::array<std::uint64_t, kClassCount>;
+
+    /// @brief Estatísticas acumuladas de uma thread.
+    struct ThreadStats
+    {
+        /// @brief Primeira entrada e última saída observadas, para calcular o tempo de parede.
+        std::uint64_t first_ns = 0;
+        std::uint64_t last_ns = 0;
+        ClassTimes blocked_ns{};
+        std::array<std::uint64_t, kClassCount> calls{};
+        /// @brief Tempo bloqueado por classe em cada intervalo de um segundo desde o início.
+        std::map<std::uint64_t, ClassTimes> timeline;
+    };
+
+    /// @brief Uma chamada bloqueante candidata ao ranking das mais longas.
+    struct BlockingCall
+    {
+        std::uint64_t duration_ns;
+        std::uint64_t entry_ns;
+        pid_t tid;
+        long nr;
+        long long ret;
+        std::string args;
+
+        /// @brief Ordena pela duração, para manter um heap de mínimo com as N maiores.
+        bool operator>(const BlockingCall &other) const
+        {
+            return duration_ns > other.duration_ns;
+        }
+    };
+
+    /**
+     * @brief Classifica um número de syscall.
+     * @return A classe, ou BlockClass::Count se a syscall não for considerada bloqueante.
+     */
+    BlockClass classify(long nr) const;
+
+    /// @brief Classe de cada número de syscall, pré-calculada a partir dos nomes.
+    std::vector<BlockClass> m_class_by_nr;
+    std::map<pid_t, ThreadStats> m_threads;
+    /// @brief Heap de mínimo com as chamadas mais longas vistas até agora.
+    std::vector<BlockingCall> m_top;
+    std::size_t m_top_n;
+    /// @brief Instante da primeira entrada observada, origem da linha do tempo. Toda chamada que
+    /// termina depois começou nela ou depois dela, mesmo as que terminam fora de ordem.
+    std::uint64_t m_origin_ns = 0;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "TraceSink.h" // Headers do projeto
+
+#include <functional> // Utilizado pelas funções registradas
+
+/**
+ * @class CallbackSink
+ * @brief Consumidor que repassa os eventos para funções, para quem usa a libtracer sem precisar
+ * derivar de TraceSink.
+ *
+ * As funções são chamadas na thread do loop do Tracer, com a thread rastreada ainda parada;
+ * o tempo gasto nelas é somado ao da syscall. Funções vazias são ignoradas.
+ */
+class CallbackSink : public TraceSink
+{
+  public:
+    /// @brief Decide, na entrada, o quanto da chamada é capturado (ver CaptureLevel).
+    using EntryCallback = std::function<CaptureLevel(const SyscallEvent &)>;
+    /// @brief Recebe a chamada completa, na saída.
+    using ExitCallback = std::function<void(const SyscallEvent &)>;
+    /// @brief Recebe os eventos de criação, exec e término.
+    using ProcessCallback = std::function<void(const ProcessEvent &)>;
+    /// @brief Chamada quando o loop de rastreamento termina.
+    using FinishCallback = std::function<void()>;
+
+    /**
+     * @brief Constrói o consumidor com as funções de cada evento.
+     * @param entry Decide o nível de captura; vazia usa Event se 'exit' existir, senão Skip.
+     * @param exit Recebe cada chamada completa.
+     * @param process Recebe os eventos de processo.
+     * @param finish Chamada ao final do rastreamento.
+     */
+    explicit CallbackSink(EntryCallback entry, ExitCallback exit = {}, ProcessCallback process = {},
+                          FinishCallback finish = {});
+
+    /// @brief Falso se só há funções de processo e de término.
+    bool wants_syscalls() const override
+    {
+        return m_entry || m_exit;
+    }
+
+    /// @brief Verdadeiro se há uma função de processo, que também recebe os eventos Exiting.
+    bool wants_exit_stops() const override
+    {
+        return static_cast<bool>(m_process);
+    }
+
+    CaptureLevel on_syscall_entry(const SyscallEvent &event) override;
+    void on_syscall_exit(const SyscallEvent &event) override;
+    void on_process_event(const ProcessEvent &event) override;
+    void on_finish() override;
+
+  private:
+    EntryCallback m_entry;
+    ExitCallback m_exit;
+    ProcessCallback m_process;
+    FinishCallback m_finish;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <string> // Utilizado pelos argumentos e respostas dos comandos
+#include <vector> // Utilizado pelas conexões com comandos ainda incompletos
+
+#include <poll.h>      // Utilizado pela struct pollfd
+#include <sys/types.h> // Utilizado pelo tipo pid_t
+
+/**
+ * @struct ControlCommand
+ * @brief Um comando recebido pelo canal de controle.
+ */
+struct ControlCommand
+{
+    /// @brief As operações aceitas pelo canal.
+    enum class Type
+    {
+        Pause,  ///< Para de gerar paradas de syscall (PTRACE_CONT em todos os tracees).
+        Resume, ///< Volta a rastrear as syscalls.
+        Filter, ///< Troca o filtro de syscalls ("all" remove o filtro).
+        Add,    ///< Anexa um processo e suas threads.
+        Remove, ///< Desanexa um processo e suas threads.
+        Detach  ///< Desanexa todos os tracees e encerra o rastreamento.
+    };
+
+    Type type = Type::Pause;
+    /// @brief O argumento do comando: a lista de syscalls do Filter.
+    std::string argument;
+    /// @brief O PID dos comandos Add e Remove.
+    pid_t pid = 0;
+    /// @brief O socket do cliente, usado para enviar a resposta.
+    int client = -1;
+};
+
+/**
+ * @class ControlChannel
+ * @brief Socket Unix local que recebe comandos de texto para controlar um Tracer em execução.
+ *
+ * Cada conexão envia um único comando em uma linha (ex: "pause", "filter read,write",
+ * "add 1234") e recebe "ok" ou "error: <motivo>". O canal não executa nada por conta própria:
+ * o loop do Tracer aguarda os descritores do canal junto com as paradas dos tracees e aplica os
+ * comandos, já que apenas a thread que rastreia pode fazer chamadas ptrace. Nenhuma leitura
+ * bloqueia: linhas incompletas ficam guardadas até o resto chegar, para que um cliente lento
+ * nunca segure os tracees parados.
+ */
+class ControlChannel
+{
+  public:
+    /**
+     * @brief Cria o socket de escuta.
+     * @param path O caminho do socket Unix.
+     */
+    explicit ControlChannel(const std::string &path);
+
+    /// @brief Fecha o socket e remove o arquivo.
+    ~ControlChannel();
+
+    ControlChannel(const ControlChannel &) = delete;
+    ControlChannel &operator=(const ControlChannel &) = delete;
+
+    /// @brief O descritor de escuta; -1 se a abertura falhou.
+    int fd() const
+    {
+        return m_fd;
+    }
+
+    /**
+     * @brief Acrescenta os descritores a aguardar com poll: o de escuta e o de cada conexão com
+     * um comando ainda incompleto.
+     * @param fds O vetor do poll.
+     */
+    void poll_fds(std::vector<pollfd> &fds) const;
+
+    /**
+     * @brief Aceita as conexões pendentes e lê, sem bloquear, o que cada uma já enviou.
+     * @param command Recebe o próximo comando completo.
+     * @return Verdadeiro se um comando válido foi lido; deve ser chamada de novo até retornar
+     * falso. Comandos inválidos já são respondidos com um erro aqui.
+     */
+    bool receive(ControlCommand &command);
+
+    /**
+     * @brief Responde ao cliente de um comando e fecha a conexão.
+     * @param command O comando respondido.
+     * @param error Vazio em caso de sucesso, ou a descrição do erro.
+     */
+    static void reply(const ControlCommand &command, const std::string &error = "");
+
+  private:
+    /// @brief Uma conexão aceita cuja linha de comando ainda não terminou.
+    struct Client
+    {
+        int fd;
+        std::string line;
+    };
+
+    /**
+     * @brief Interpreta uma linha de comando completa.
+     * @return Verdadeiro se o comando é válido; senão ele já foi respondido com um erro.
+     */
+    static bool parse(std::string line, ControlCommand &command);
+
+    int m_fd = -1;
+    std::string m_path;
+    /// @brief Conexões aguardando o resto da linha.
+    std::vector<Client> m_clients;
+};
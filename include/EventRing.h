@@ -0,0 +1,273 @@
+#pragma once
+
+#include <atomic>  // Utilizado pelos números de sequência e pela palavra do futex
+#include <cerrno>  // Utilizado pelo errno das falhas ao abrir o anel
+#include <cstddef> // Utilizado pelo offsetof das verificações do layout
+#include <cstdint> // Utilizado pelos tipos de tamanho fixo do layout
+#include <cstring> // Utilizado pelo memcpy dos eventos e pela comparação do identificador
+#include <string>  // Utilizado pelo nome do objeto de memória compartilhada
+
+#include <fcntl.h>       // Utilizado pelo O_RDWR do shm_open
+#include <linux/futex.h> // Utilizado pelo FUTEX_WAIT e FUTEX_WAKE
+#include <sys/mman.h>    // Utilizado pelo shm_open e mmap
+#include <sys/stat.h>    // Utilizado pelo fstat do tamanho do objeto
+#include <sys/syscall.h> // Utilizado pelo SYS_futex
+#include <time.h>        // Utilizado pela struct timespec do tempo limite
+#include <unistd.h>      // Utilizado pelo syscall() e close()
+
+/**
+ * @brief Layout do anel de eventos em memória compartilhada publicado com --shm-ring.
+ *
+ * O objeto /dev/shm/<nome> começa com um EventRingHeader, seguido de 'capacity' EventRingSlot
+ * (a partir de 'header_size'). O Tracer é o único escritor: o evento de número n (a partir de 0)
+ * vai para o slot n % capacity, sobrescrevendo o evento n - capacity. O escritor nunca espera
+ * pelos leitores; um leitor lento perde eventos e percebe isso pelos números de sequência.
+ *
+ * Protocolo de escrita de um slot (um seqlock por slot):
+ *   1. slot.seq = 0 (escrita em andamento);
+ *   2. copia o evento para slot.event;
+ *   3. slot.seq = n + 1, com ordem release;
+ *   4. header.write_seq = n + 1;
+ *   5. se header.waiters > 0, incrementa header.futex e faz FUTEX_WAKE nele.
+ *
+ * Cada leitor guarda o seu próprio cursor (o número do próximo evento) e lê o slot cursor %
+ * capacity: se slot.seq == cursor + 1, copia o evento e confere que slot.seq não mudou; se
+ * slot.seq é maior, o escritor já deu a volta e os eventos entre o cursor e write_seq -
+ * capacity foram perdidos. Para dormir, o leitor lê header.futex, incrementa header.waiters,
+ * confere que write_seq ainda é igual ao cursor e faz FUTEX_WAIT (compartilhado, sem
+ * FUTEX_PRIVATE_FLAG) com o valor lido. Não há cópia nem serialização: cada leitor lê direto da
+ * memória compartilhada, e qualquer quantidade de leitores pode seguir o mesmo anel.
+ *
+ * O EventRingReader abaixo implementa o lado do leitor e depende apenas deste arquivo. Os campos
+ * estão na ordem de bytes da máquina do Tracer.
+ */
+namespace EventRingFormat
+{
+/// @brief Identifica um anel de eventos do TracerC.
+inline constexpr char kMagic[8] = {'T', 'R', 'C', 'R', 'I', 'N', 'G', '\0'};
+/// @brief Versão atual do layout.
+inline constexpr std::uint32_t kVersion = 1;
+} // namespace EventRingFormat
+
+/**
+ * @brief O tipo de um evento do anel.
+ */
+enum class EventRingType : std::uint32_t
+{
+    Syscall = 1, ///< Uma syscall completa (entrada e saída).
+    Fork,        ///< Um processo novo criado com fork.
+    Vfork,       ///< Um processo novo criado com vfork.
+    Clone,       ///< Uma thread (ou processo) nova criada com clone.
+    Exec,        ///< Um processo executou um novo programa.
+    Exit         ///< Uma thread terminou.
+};
+
+/**
+ * @struct EventRingEvent
+ * @brief Um evento publicado no anel.
+ */
+struct EventRingEvent
+{
+    /// @brief Um valor de EventRingType.
+    std::uint32_t type;
+    std::int32_t tid;
+    std::int32_t pid;
+    /// @brief O número da syscall; -1 em eventos de processo.
+    std::int32_t nr;
+    /// @brief A thread e o processo criados, em eventos Fork, Vfork e Clone.
+    std::int32_t child_tid;
+    std::int32_t child_pid;
+    /// @brief O status do waitpid, em eventos Exit.
+    std::int32_t status;
+    std::uint32_t reserved;
+    /// @brief Entrada e saída da syscall; em eventos de processo, ambos são o instante do evento.
+    std::uint64_t entry_ns;
+    std::uint64_t exit_ns;
+    /// @brief O valor de retorno; valores entre -4095 e -1 são um errno negado.
+    std::int64_t ret;
+    /// @brief O endereço logo após a instrução 'syscall'.
+    std::uint64_t ip;
+    /// @brief Os argumentos crus, na ordem da ABI x86-64.
+    std::uint64_t args[6];
+};
+
+/**
+ * @struct EventRingSlot
+ * @brief Um slot do anel, com o número de sequência do evento que ele guarda.
+ */
+struct alignas(64) EventRingSlot
+{
+    /// @brief n + 1 quando o slot guarda o evento n completo; 0 durante a escrita.
+    std::atomic<std::uint64_t> seq;
+    EventRingEvent event;
+};
+
+/**
+ * @struct EventRingHeader
+ * @brief Cabeçalho do anel. Os contadores ficam em linhas de cache separadas dos campos fixos.
+ */
+struct EventRingHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    /// @brief Deslocamento do primeiro slot a partir do início do objeto.
+    std::uint32_t header_size;
+    /// @brief Tamanho de cada slot, para que leitores reconheçam slots estendidos.
+    std::uint32_t slot_size;
+    /// @brief Quantidade de slots; sempre uma potência de dois.
+    std::uint32_t capacity;
+    /// @brief Quantidade de eventos já publicados (o número do próximo evento).
+    alignas(64) std::atomic<std::uint64_t> write_seq;
+    /// @brief Palavra do futex, incrementada a cada wake.
+    alignas(64) std::atomic<std::uint32_t> futex;
+    /// @brief Leitores dormindo no futex; o escritor só faz o wake se houver algum.
+    std::atomic<std::uint32_t> waiters;
+    /// @brief 1 depois que o Tracer terminou; nenhum evento novo será publicado.
+    std::atomic<std::uint32_t> closed;
+};
+
+static_assert(sizeof(EventRingEvent) == 112, "o evento faz parte do layout compartilhado");
+static_assert(sizeof(EventRingSlot) == 128, "o slot faz parte do layout compartilhado");
+static_assert(offsetof(EventRingHeader, write_seq) == 64, "layout compartilhado");
+static_assert(offsetof(EventRingHeader, futex) == 128, "layout compartilhado");
+static_assert(sizeof(EventRingHeader) == 192, "o cabeçalho faz parte do layout compartilhado");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "os contadores precisam funcionar entre processos");
+
+/**
+ * @class EventRingReader
+ * @brief Leitor de um anel de eventos, com o seu próprio cursor.
+ */
+class EventRingReader
+{
+  public:
+    EventRingReader() = default;
+    EventRingReader(const EventRingReader &) = delete;
+    EventRingReader &operator=(const EventRingReader &) = delete;
+
+    ~EventRingReader()
+    {
+        if (m_header)
+            munmap(m_header, m_size);
+    }
+
+    /**
+     * @brief Abre o anel e posiciona o cursor no próximo evento a ser publicado.
+     * @param name O nome do objeto de memória compartilhada (ex: "/tracerc").
+     * @param error Recebe a descrição do problema, se houver.
+     * @return Verdadeiro se o anel foi aberto.
+     */
+    bool open(const std::string &name, std::string &error)
+    {
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0)
+        {
+            error = "shm_open: " + std::string(std::strerror(errno));
+            return false;
+        }
+        struct stat st;
+        void *base = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(EventRingHeader)))
+            base = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED)
+        {
+            error = "mmap failed";
+            return false;
+        }
+        m_header = static_cast<EventRingHeader *>(base);
+        m_size = st.st_size;
+        if (std::memcmp(m_header->magic, EventRingFormat::kMagic, sizeof(m_header->magic)) != 0 ||
+            m_header->version != EventRingFormat::kVersion ||
+            m_header->slot_size != sizeof(EventRingSlot) ||
+            m_header->header_size + std::size_t{m_header->capacity} * sizeof(EventRingSlot) >
+                m_size)
+        {
+            error = "not a compatible TracerC event ring";
+            return false;
+        }
+        m_slots = reinterpret_cast<EventRingSlot *>(static_cast<char *>(base) +
+                                                    m_header->header_size);
+        m_cursor = m_header->write_seq.load(std::memory_order_acquire);
+        return true;
+    }
+
+    /**
+     * @brief Copia o próximo evento, se houver.
+     * @param out Recebe o evento.
+     * @return Verdadeiro se um evento foi copiado.
+     */
+    bool try_read(EventRingEvent &out)
+    {
+        while (true)
+        {
+            EventRingSlot &slot = m_slots[m_cursor & (m_header->capacity - 1)];
+            std::uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            if (seq == m_cursor + 1)
+            {
+                std::memcpy(&out, &slot.event, sizeof(out));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.seq.load(std::memory_order_relaxed) == seq)
+                {
+                    ++m_cursor;
+                    return true;
+                }
+            }
+            else if (seq < m_cursor + 1)
+            {
+                // O slot ainda guarda um evento antigo, ou está sendo escrito.
+                std::uint64_t written = m_header->write_seq.load(std::memory_order_acquire);
+                if (written <= m_cursor)
+                    return false; // Nada novo.
+                if (written < m_cursor + m_header->capacity)
+                    continue; // O evento foi publicado entre as duas leituras.
+            }
+
+            // O escritor deu a volta (ou está sobrescrevendo este slot): pula para o evento
+            // mais antigo que ainda está no anel.
+            std::uint64_t oldest = m_header->write_seq.load(std::memory_order_acquire);
+            oldest = oldest > m_header->capacity ? oldest - m_header->capacity + 1 : 0;
+            if (oldest > m_cursor)
+            {
+                m_lost += oldest - m_cursor;
+                m_cursor = oldest;
+            }
+        }
+    }
+
+    /**
+     * @brief Dorme até haver eventos novos, o anel ser fechado ou o tempo acabar.
+     * @param timeout_ms O tempo limite em milissegundos; negativo espera sem limite.
+     */
+    void wait(int timeout_ms)
+    {
+        std::uint32_t word = m_header->futex.load();
+        m_header->waiters.fetch_add(1);
+        if (m_header->write_seq.load() == m_cursor && !m_header->closed.load())
+        {
+            struct timespec timeout = {timeout_ms / 1000, (timeout_ms % 1000) * 1000000L};
+            syscall(SYS_futex, &m_header->futex, FUTEX_WAIT, word,
+                    timeout_ms < 0 ? nullptr : &timeout, nullptr, 0);
+        }
+        m_header->waiters.fetch_sub(1);
+    }
+
+    /// @brief Verdadeiro depois que o Tracer terminou.
+    bool closed() const
+    {
+        return m_header->closed.load() != 0;
+    }
+
+    /// @brief Quantidade de eventos perdidos porque o escritor deu a volta no anel.
+    std::uint64_t lost() const
+    {
+        return m_lost;
+    }
+
+  private:
+    EventRingHeader *m_header = nullptr;
+    EventRingSlot *m_slots = nullptr;
+    std::size_t m_size = 0;
+    std::uint64_t m_cursor = 0;
+    std::uint64_t m_lost = 0;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "EventRing.h" // Headers do projeto
+#include "TraceSink.h" // Headers do projeto
+
+#include <cstddef> // Utilizado pelo tamanho do mapeamento
+#include <cstdint> // Utilizado pela quantidade de slots
+#include <string>  // Utilizado pelo nome do objeto de memória compartilhada
+
+/**
+ * @class EventRingPublisher
+ * @brief Publica cada evento no anel de memória compartilhada descrito em EventRing.h.
+ *
+ * O anel é criado em /dev/shm com shm_open e os eventos são escritos direto nos slots, sem
+ * serialização nem E/S de arquivo. O Tracer nunca espera pelos leitores, e só faz uma syscall
+ * (o FUTEX_WAKE) quando há algum leitor dormindo. Ao terminar, o anel é marcado como fechado e
+ * o nome é removido; leitores que já o mapearam continuam lendo os últimos eventos.
+ */
+class EventRingPublisher : public TraceSink
+{
+  public:
+    /// @brief Quantidade de slots quando a especificação não define uma.
+    static constexpr std::uint32_t kDefaultSlots = 65536;
+
+    /**
+     * @brief Interpreta a especificação "<nome>[:<slots>]" da linha de comando.
+     * @param spec A especificação, ex: "tracerc:131072".
+     * @param name Recebe o nome do objeto, já com a barra inicial ("/tracerc").
+     * @param slots Recebe a quantidade de slots, uma potência de dois.
+     * @param error Recebe a descrição do problema, se houver.
+     * @return Verdadeiro se a especificação é válida.
+     */
+    static bool parse_spec(const std::string &spec, std::string &name, std::uint32_t &slots,
+                           std::string &error);
+
+    /**
+     * @brief Cria o objeto de memória compartilhada e inicializa o cabeçalho.
+     * @param name O nome do objeto, com a barra inicial.
+     * @param slots A quantidade de slots, uma potência de dois.
+     */
+    EventRingPublisher(const std::string &name, std::uint32_t slots);
+
+    /// @brief Desfaz o mapeamento e remove o nome, se o anel ainda estiver aberto.
+    ~EventRingPublisher() override;
+
+    /// @brief Falso se o anel não pôde ser criado (nome já existente, shm_open, ftruncate ou
+    /// mmap); nesse caso nenhum evento é publicado.
+    bool valid() const
+    {
+        return m_header != nullptr;
+    }
+
+    EventRingPublisher(const EventRingPublisher &) = delete;
+    EventRingPublisher &operator=(const EventRingPublisher &) = delete;
+
+    /// @brief Publica só os campos crus do evento; os argumentos nunca são formatados.
+    CaptureLevel on_syscall_entry(const SyscallEvent &) override
+    {
+        return CaptureLevel::Event;
+    }
+
+    void on_syscall_exit(const SyscallEvent &event) override;
+    void on_process_event(const ProcessEvent &event) override;
+
+    /// @brief Marca o anel como fechado e acorda os leitores.
+    void on_finish() override;
+
+  private:
+    /// @brief Escreve um evento no próximo slot e acorda os leitores que estiverem dormindo.
+    void publish(const EventRingEvent &event);
+
+    /// @brief Acorda todos os leitores dormindo no futex do cabeçalho.
+    void wake();
+
+    std::string m_name;
+    EventRingHeader *m_header = nullptr;
+    EventRingSlot *m_slots = nullptr;
+    std::size_t m_size = 0;
+    std::uint64_t m_next = 0;
+    std::uint64_t m_mask = 0;
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "TraceSink.h" // Headers do projeto
+
+#include <cstdint> // Utilizado pelos operandos das instruções
+#include <memory>  // Utilizado pelo std::unique_ptr retornado pela compilação
+#include <string>  // Utilizado pelo texto da expressão e mensagens de erro
+#include <vector>  // Utilizado pelo bytecode e pelos conjuntos
+
+/**
+ * @class FilterProgram
+ * @brief Uma expressão de --filter compilada para bytecode.
+ *
+ * A expressão é lida uma única vez e vira uma sequência pós-fixa de comparações e operadores
+ * lógicos. Nomes e expressões regulares de syscalls já são resolvidos na compilação para um
+ * conjunto de números, então a avaliação só compara inteiros, sem alocar memória.
+ *
+ * A avaliação é feita em três valores (verdadeiro, falso, desconhecido), porque nem todos os
+ * campos existem em todos os momentos: ao registrar uma thread só o pid e o tid são conhecidos, e
+ * o ret e a duração só existem na saída da syscall. Um resultado falso com campos desconhecidos é
+ * definitivo, o que permite descartar a syscall (ou a thread inteira) o mais cedo possível.
+ *
+ * Gramática:
+ * @code
+ * expr    := and ("||" and)*
+ * and     := unary ("&&" unary)*
+ * unary   := "!" unary | "(" expr ")" | compare
+ * compare := field ("==" | "!=" | "<" | "<=" | ">" | ">=") value
+ *          | field "in" "{" value ("," value)* "}"
+ *          | "syscall" "=~" string
+ * field   := pid | tid | syscall | ret | dur | arg0 ... arg5
+ * @endcode
+ */
+class FilterProgram
+{
+  public:
+    /// @brief Resultado de uma avaliação.
+    enum class Result : std::uint8_t
+    {
+        False,
+        True,
+        Unknown ///< Depende de campos que ainda não são conhecidos.
+    };
+
+    /// @brief Quais campos do evento já são conhecidos.
+    enum class Phase
+    {
+        Thread, ///< Apenas pid e tid (ao registrar uma thread).
+        Entry,  ///< Também syscall e argumentos (na entrada da syscall).
+        Exit    ///< Todos os campos, incluindo ret e dur (na saída da syscall).
+    };
+
+    /**
+     * @brief Compila uma expressão.
+     * @param text O texto da expressão.
+     * @param error Recebe a descrição do erro, com a posição, se houver.
+     * @return O programa, ou nullptr se a expressão for inválida.
+     */
+    static std::unique_ptr<FilterProgram> compile(const std::string &text, std::string &error);
+
+    /**
+     * @brief Avalia o programa sobre um evento.
+     * @param event O evento; só os campos conhecidos na fase são lidos.
+     * @param phase A fase em que o evento está.
+     */
+    Result evaluate(const SyscallEvent &event, Phase phase) const;
+
+  private:
+    /// @brief Os campos de um evento que podem ser comparados.
+    enum class Field : std::uint8_t
+    {
+        Pid,
+        Tid,
+        Syscall,
+        Ret,
+        Dur,
+        Arg0 ///< Arg0 a Arg5 são consecutivos.
+    };
+
+    enum class OpCode : std::uint8_t
+    {
+        Eq,
+        Ne,
+        Lt,
+        Le,
+        Gt,
+        Ge,
+        InSet,     ///< O campo está no conjunto ordenado m_sets[index].
+        InSyscall, ///< O número da syscall está no conjunto m_syscall_sets[index].
+        And,
+        Or,
+        Not
+    };
+
+    struct Instruction
+    {
+        OpCode op;
+        Field field;
+        std::uint32_t index; ///< Índice do conjunto de InSet e InSyscall.
+        long long value;     ///< Operando das comparações.
+    };
+
+    /// @brief Profundidade máxima da pilha de avaliação, verificada na compilação.
+    static constexpr std::size_t kMaxStack = 64;
+
+    class Parser;
+
+    std::vector<Instruction> m_code;
+    std::vector<std::vector<long long>> m_sets;
+    std::vector<std::vector<bool>> m_syscall_sets;
+};
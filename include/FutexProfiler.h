@@ -0,0 +1,101 @@
+#pragma once
+
+#include "ProcMaps.h"  // Headers do projeto
+#include "TraceSink.h" // Headers do projeto
+
+#include <array>   // Utilizado pela contagem de cada operação
+#include <cstddef> // Utilizado pelo tipo size_t
+#include <cstdint> // Utilizado pelos endereços e tempos
+#include <map>     // Utilizado pelas estatísticas por endereço e por thread
+#include <set>     // Utilizado pelas threads que esperaram em cada endereço
+#include <string>  // Utilizado pelo local resolvido de cada endereço
+#include <utility> // Utilizado pelo std::pair das chaves (pid, endereço) e (pid, tid)
+#include <vector>  // Utilizado pela classificação por syscall e pelas threads que terminaram
+
+/**
+ * @class FutexProfiler
+ * @brief Perfil de contenção de locks a partir das chamadas de futex.
+ *
+ * Decodifica a operação de cada futex (WAIT, WAKE, WAIT_BITSET, LOCK_PI, ...) e acumula, por
+ * endereço de futex e por thread, as esperas, o tempo esperado e os wakes. Uma espera que
+ * retorna EAGAIN não dormiu (o valor já tinha mudado) e é contada à parte. Ao final registra os
+ * N endereços com mais tempo de espera, traduzidos para "módulo+deslocamento" pelo
+ * /proc/[pid]/maps quando possível, e as N threads que mais esperaram.
+ */
+class FutexProfiler : public TraceSink
+{
+  public:
+    /**
+     * @brief Constrói o profiler.
+     * @param top_n Quantidade de endereços e threads listados no relatório.
+     */
+    explicit FutexProfiler(std::size_t top_n);
+
+    /// @brief Pede só o evento cru das syscalls de futex e dispensa as demais.
+    CaptureLevel on_syscall_entry(const SyscallEvent &event) override;
+
+    void on_syscall_exit(const SyscallEvent &event) override;
+    void on_process_event(const ProcessEvent &event) override;
+
+    /// @brief Registra o relatório no log.
+    void on_finish() override;
+
+  private:
+    /// @brief As syscalls de futex decodificadas.
+    enum class Kind
+    {
+        None,
+        Futex,     ///< futex(uaddr, op, ...): a operação vem no segundo argumento.
+        FutexWait, ///< futex_wait(uaddr, ...), a partir do Linux 6.7.
+        FutexWake  ///< futex_wake(uaddr, ...), a partir do Linux 6.7.
+    };
+
+    /// @brief Quantidade de operações do futex (FUTEX_WAIT a FUTEX_LOCK_PI2).
+    static constexpr std::size_t kOpCount = 14;
+
+    /// @brief Estatísticas de um endereço de futex.
+    struct AddressStats
+    {
+        /// @brief O endereço traduzido, resolvido na primeira vez que aparece.
+        std::string location;
+        /// @brief Esperas que dormiram (retornaram por wake, timeout ou sinal).
+        std::size_t waits = 0;
+        /// @brief Esperas que não dormiram porque o valor já tinha mudado (EAGAIN).
+        std::size_t eagain = 0;
+        std::size_t timeouts = 0;
+        std::uint64_t wait_ns = 0;
+        std::uint64_t max_wait_ns = 0;
+        std::size_t wakes = 0;
+        /// @brief Threads acordadas (ou movidas, no REQUEUE) pelos wakes.
+        std::size_t woken = 0;
+        /// @brief Wakes que não encontraram ninguém esperando.
+        std::size_t empty_wakes = 0;
+        std::set<pid_t> waiters;
+        std::array<std::size_t, kOpCount> ops{};
+    };
+
+    /// @brief Tempo de espera de uma thread.
+    struct ThreadStats
+    {
+        std::size_t waits = 0;
+        std::uint64_t wait_ns = 0;
+        std::uint64_t max_wait_ns = 0;
+        /// @brief O processo da thread.
+        pid_t pid = 0;
+        pid_t tid = 0;
+        /// @brief Tempo de espera por endereço, para achar o mais quente.
+        std::map<std::uint64_t, std::uint64_t> by_address;
+    };
+
+    /// @brief Retorna as estatísticas do endereço, resolvendo-o na primeira vez.
+    AddressStats &address(pid_t pid, std::uint64_t uaddr);
+
+    std::vector<Kind> m_kind_by_nr;
+    std::map<std::pair<pid_t, std::uint64_t>, AddressStats> m_addresses;
+    /// @brief Threads vivas, por (pid, tid): um TID pode voltar em outro processo.
+    std::map<std::pair<pid_t, pid_t>, ThreadStats> m_threads;
+    /// @brief Threads que já terminaram, mantidas para o relatório.
+    std::vector<ThreadStats> m_exited_threads;
+    std::size_t m_top_n;
+    ProcMaps m_maps;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "TraceSink.h" // Headers do projeto
+
+#include <array>         // Utilizado pelas tabelas de contadores de tamanho fixo
+#include <atomic>        // Utilizado pelos contadores compartilhados entre as threads
+#include <cstddef>       // Utilizado pelo tipo size_t
+#include <string>        // Utilizado pelo endereço de escuta e pelo texto gerado
+#include <thread>        // Utilizado pela thread do servidor HTTP
+#include <unordered_map> // Utilizado pelo índice de entradas por PID
+#include <vector>        // Utilizado pela lista de entradas livres
+
+/**
+ * @class MetricsExporter
+ * @brief Exporta contadores de syscalls no formato de texto OpenMetrics (Prometheus).
+ *
+ * O loop do Tracer apenas incrementa contadores atômicos com ordenação relaxada. Um pequeno
+ * servidor HTTP, em sua própria thread, lê esses contadores a cada coleta. Assim uma coleta nunca
+ * segura uma parada do ptrace: não há nenhum lock compartilhado entre as duas threads.
+ */
+class MetricsExporter : public TraceSink
+{
+  public:
+    /**
+     * @brief Abre o socket de escuta e inicia a thread do servidor.
+     * @param listen O caminho de um socket Unix ou um endereço "127.0.0.1:<porta>".
+     */
+    explicit MetricsExporter(const std::string &listen);
+
+    /// @brief Encerra a thread do servidor e fecha os sockets.
+    ~MetricsExporter() override;
+
+    MetricsExporter(const MetricsExporter &) = delete;
+    MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+    /// @brief Os contadores só usam o número, o retorno e os timestamps da syscall.
+    CaptureLevel on_syscall_entry(const SyscallEvent &) override
+    {
+        return CaptureLevel::Event;
+    }
+
+    void on_syscall_exit(const SyscallEvent &event) override;
+
+    /// @brief Libera a entrada de um processo quando ele termina.
+    void on_process_event(const ProcessEvent &event) override;
+
+  private:
+    /// @brief Maior número de syscall com contadores próprios.
+    static constexpr std::size_t kMaxSyscalls = 512;
+    /// @brief Quantidade de processos vivos com contadores próprios; os demais vão para "other".
+    static constexpr std::size_t kMaxPids = 4096;
+    /// @brief Maior errno com contador próprio.
+    static constexpr std::size_t kMaxErrno = 160;
+    /// @brief Limites superiores dos buckets do histograma de latência, em nanossegundos.
+    static constexpr std::array<std::uint64_t, 8> kBucketsNs = {
+        1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000, 10000000000};
+
+    /// @brief Contadores de uma syscall.
+    struct SyscallCounters
+    {
+        std::atomic<std::uint64_t> errors{0};
+        std::atomic<std::uint64_t> duration_ns{0};
+        /// @brief Contagem por bucket (não cumulativa); o último é o "+Inf".
+        std::array<std::atomic<std::uint64_t>, kBucketsNs.size() + 1> buckets{};
+    };
+
+    /// @brief Contadores de um processo, em uma tabela de entradas reaproveitadas.
+    struct PidCounters
+    {
+        /// @brief O PID dono da entrada; zero indica uma entrada livre.
+        std::atomic<pid_t> pid{0};
+        std::atomic<std::uint64_t> calls{0};
+        std::atomic<std::uint64_t> errors{0};
+    };
+
+    /**
+     * @brief Procura (ou cria) a entrada de um processo. Só é chamada pela thread do Tracer.
+     * @return A entrada, ou nullptr se a tabela estiver cheia.
+     */
+    PidCounters *find_pid(pid_t pid);
+
+    /// @brief Loop da thread do servidor: aceita conexões e responde as coletas.
+    void serve();
+
+    /// @brief Gera o texto OpenMetrics com o estado atual dos contadores.
+    std::string render() const;
+
+    std::array<SyscallCounters, kMaxSyscalls> m_syscalls;
+    std::array<PidCounters, kMaxPids> m_pids;
+    /// @brief Entrada de cada processo vivo em m_pids. Só é usado pela thread do Tracer.
+    std::unordered_map<pid_t, std::size_t> m_slot_by_pid;
+    /// @brief Entradas de m_pids liberadas por processos que terminaram.
+    std::vector<std::size_t> m_free_slots;
+    /// @brief Quantidade de entradas de m_pids já usadas alguma vez.
+    std::size_t m_used_slots = 0;
+    std::atomic<std::uint64_t> m_other_pid_calls{0};
+    std::atomic<std::uint64_t> m_other_pid_errors{0};
+    std::array<std::atomic<std::uint64_t>, kMaxErrno> m_errnos{};
+
+    /// @brief O socket de escuta, ou -1 se a abertura falhou.
+    int m_listen_fd = -1;
+    /// @brief eventfd usado para acordar e encerrar a thread do servidor.
+    int m_wake_fd = -1;
+    /// @brief Caminho do socket Unix, removido ao encerrar.
+    std::string m_unix_path;
+    std::thread m_thread;
+};
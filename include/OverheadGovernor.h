@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef> // Utilizado pelo índice das syscalls
+#include <cstdint> // Utilizado pelos contadores e instantes em nanossegundos
+#include <map>     // Utilizado pelas paradas por thread
+#include <set>     // Utilizado pelo conjunto de threads amostradas
+#include <string>  // Utilizado pela especificação da linha de comando
+#include <vector>  // Utilizado pelas tabelas indexadas pelo número da syscall
+
+#include <sys/types.h> // Utilizado pelo tipo pid_t
+
+/**
+ * @class OverheadGovernor
+ * @brief Mantém a taxa de paradas do ptrace dentro de um orçamento, estreitando o rastreamento
+ * sob carga e restaurando-o quando a carga passa.
+ *
+ * A cada janela de um segundo, a taxa de paradas (duas por syscall) é comparada com o
+ * orçamento. Acima dele, o ajuste é feito em dois níveis:
+ *   1. as syscalls mais frequentes passam a ser só contadas: a entrada ainda para, mas nada é
+ *      formatado, registrado ou repassado aos sinks, e a saída nem é lida;
+ *   2. se a taxa continua acima e a amostragem foi pedida, as threads mais ativas passam a ser
+ *      amostradas: em cada período de um segundo, elas são rastreadas só durante uma fração do
+ *      período e rodam com PTRACE_CONT no resto, sem nenhuma parada. Cada volta ao rastreamento
+ *      custa um SIGSTOP, que faz syscalls como epoll_wait, semop e sigtimedwait retornarem EINTR
+ *      na thread; por isso esse nível só existe com a opção explícita e o período é longo.
+ * Abaixo da metade do orçamento, os ajustes são desfeitos na ordem inversa. O ptrace não
+ * filtra syscalls no kernel, então só o segundo nível reduz a quantidade de paradas; o primeiro
+ * reduz o custo de cada uma. Cada ajuste é registrado no log com o prefixo GOVERNOR.
+ *
+ * A classe só decide; o Tracer aplica as decisões às threads.
+ */
+class OverheadGovernor
+{
+  public:
+    /// @brief Duração de cada janela de medição.
+    static constexpr std::uint64_t kWindowNs = 1000000000;
+    /// @brief Duração de cada período de amostragem. Cada período traz as threads amostradas de
+    /// volta com um SIGSTOP, o que injeta no máximo um EINTR por segundo em cada uma.
+    static constexpr std::uint64_t kPeriodNs = 1000000000;
+
+    /**
+     * @brief Interpreta a especificação "<paradas/s>[,sample]" da linha de comando.
+     * @param spec A especificação, ex: "50000,sample".
+     * @param budget Recebe o orçamento, maior que zero.
+     * @param sampling Recebe verdadeiro se o segundo nível (amostragem) foi pedido.
+     * @param error Recebe a descrição do problema, se houver.
+     * @return Verdadeiro se a especificação é válida.
+     */
+    static bool parse_spec(const std::string &spec, std::uint64_t &budget, bool &sampling,
+                           std::string &error);
+
+    /**
+     * @brief Constrói o governador.
+     * @param budget O orçamento, em paradas por segundo.
+     * @param sampling Permite o segundo nível, que amostra as threads com SIGSTOP.
+     * @param now_ns O instante atual, que inicia a primeira janela.
+     */
+    OverheadGovernor(std::uint64_t budget, bool sampling, std::uint64_t now_ns);
+
+    /**
+     * @brief Conta as paradas de uma syscall, na sua entrada.
+     * @param tid A thread que fez a chamada.
+     * @param nr O número da syscall.
+     * @return Verdadeiro se a syscall está só sendo contada e não deve ser tratada.
+     */
+    bool record(pid_t tid, long nr);
+
+    /// @brief O instante em que tick() precisa ser chamado de novo.
+    std::uint64_t deadline() const
+    {
+        return m_deadline;
+    }
+
+    /**
+     * @brief Fecha a janela e troca a fase de amostragem, quando for a hora.
+     * @param now_ns O instante atual.
+     * @return As threads que voltam a ser rastreadas e precisam de um SIGSTOP para sair do
+     * PTRACE_CONT.
+     */
+    std::vector<pid_t> tick(std::uint64_t now_ns);
+
+    /// @brief Verdadeiro se a thread está amostrada e fora da fase rastreada.
+    bool sampled_out(pid_t tid) const
+    {
+        return !m_in_phase && m_sampled.count(tid);
+    }
+
+    /// @brief Esquece uma thread que terminou.
+    void forget(pid_t tid);
+
+    /// @brief Registra o resumo dos ajustes e das chamadas que foram só contadas.
+    void report() const;
+
+  private:
+    /**
+     * @brief Avalia a janela que terminou e decide os ajustes.
+     * @param now_ns O fim da janela.
+     * @param wake Recebe as threads que precisam voltar do PTRACE_CONT.
+     */
+    void evaluate(std::uint64_t now_ns, std::vector<pid_t> &wake);
+
+    /// @brief Estima a taxa de paradas de uma thread como se ela fosse rastreada o tempo todo.
+    double full_rate(pid_t tid, std::uint64_t stops, double seconds) const;
+
+    std::uint64_t m_budget;
+    /// @brief Se o segundo nível pode ser usado.
+    bool m_sampling;
+    /// @brief Se o aviso de orçamento excedido sem amostragem já foi registrado.
+    bool m_sampling_hint_logged = false;
+
+    std::uint64_t m_window_start;
+    std::uint64_t m_period_start;
+    std::uint64_t m_deadline;
+
+    /// @brief Paradas na janela atual, por syscall e por thread.
+    std::vector<std::uint64_t> m_stops_by_nr;
+    std::map<pid_t, std::uint64_t> m_stops_by_tid;
+
+    /// @brief Syscalls no primeiro nível (só contadas), indexadas pelo número.
+    std::vector<bool> m_count_only;
+    /// @brief Chamadas só contadas em toda a execução, por syscall.
+    std::vector<std::uint64_t> m_counted;
+
+    /// @brief Threads no segundo nível (amostradas) e a fração rastreada de cada período.
+    std::set<pid_t> m_sampled;
+    double m_fraction = 1.0;
+    /// @brief Verdadeiro durante a fração rastreada do período.
+    bool m_in_phase = true;
+
+    /// @brief Quantidade de ajustes feitos, para o resumo.
+    std::size_t m_adjustments = 0;
+};
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "ProcMaps.h"  // Headers do projeto
+#include "TraceSink.h" // Headers do projeto
+
+#include <array>   // Utilizado pelos contadores de cada padrão
+#include <cstddef> // Utilizado pelo tipo size_t
+#include <map>     // Utilizado pelos estados por thread, por processo e por caminho
+#include <string>  // Utilizado pelos caminhos e exemplos
+#include <vector>  // Utilizado pela classificação por número de syscall e pelos exemplos
+
+/**
+ * @brief Padrões de uso de syscalls que costumam indicar um problema de desempenho.
+ */
+enum class AdvicePattern
+{
+    TinyIo,         ///< Leituras ou escritas pequenas em sequência no mesmo descritor.
+    RepeatedLookup, ///< stat/open/access repetidos do mesmo caminho.
+    FstatAfterOpen, ///< fstat do descritor logo depois de abri-lo.
+    SeekThenIo,     ///< lseek seguido de read/write no mesmo descritor (pread/pwrite).
+    PollBusyLoop,   ///< poll/select/epoll com tempo limite zero em sequência, sem eventos.
+    MemoryChurn,    ///< Muitas chamadas de brk/mmap/munmap por segundo.
+    SyncStorm,      ///< Muitas chamadas de fsync/fdatasync por segundo.
+    Count           ///< Quantidade de padrões, não é um padrão válido.
+};
+
+/**
+ * @class PatternAdvisor
+ * @brief Procura padrões ineficientes de syscalls e os relata com exemplos.
+ *
+ * Cada padrão é detectado sobre o fluxo de eventos já decodificado pelo Tracer, com um estado
+ * pequeno por thread (a syscall anterior e as sequências em andamento) e por processo (caminhos
+ * consultados e janelas de um segundo). Ao final o relatório traz, por padrão, a quantidade de
+ * chamadas envolvidas, uma sugestão e alguns exemplos com o local da chamada no formato
+ * "módulo+deslocamento".
+ */
+class PatternAdvisor : public TraceSink
+{
+  public:
+    PatternAdvisor();
+
+    /// @brief Pede os argumentos formatados só das syscalls que consultam um caminho; as demais
+    /// só precisam dos registradores.
+    CaptureLevel on_syscall_entry(const SyscallEvent &event) override;
+
+    void on_syscall_exit(const SyscallEvent &event) override;
+    void on_process_event(const ProcessEvent &event) override;
+
+    /// @brief Registra o relatório no log.
+    void on_finish() override;
+
+  private:
+    /// @brief O papel de uma syscall para os detectores.
+    enum class Kind
+    {
+        None,
+        Read,         ///< read/recvfrom: E/S pequena e par com lseek.
+        Write,        ///< write/sendto: E/S pequena e par com lseek.
+        PositionalIo, ///< pread64/pwrite64: apenas E/S pequena.
+        Open,         ///< open/openat/creat: consulta de caminho e descritor aberto.
+        PathLookup,   ///< stat/lstat/access/faccessat.
+        StatAt,       ///< newfstatat/statx: consulta de caminho, ou fstat com AT_EMPTY_PATH.
+        Fstat,        ///< fstat.
+        Lseek,        ///< lseek.
+        PollMs,       ///< poll/epoll_wait/epoll_pwait: tempo limite em milissegundos.
+        PollTimespec, ///< ppoll/pselect6/epoll_pwait2: ponteiro para struct timespec.
+        PollTimeval,  ///< select: ponteiro para struct timeval.
+        Memory,       ///< brk/mmap/munmap/mremap.
+        Sync          ///< fsync/fdatasync/sync_file_range/msync/syncfs.
+    };
+
+    /// @brief O papel de uma syscall e o índice do argumento relevante: o tamanho (E/S), o
+    /// caminho (open e consultas), as flags (StatAt e mmap; -1 se não houver) ou o tempo limite.
+    struct Role
+    {
+        Kind kind = Kind::None;
+        int arg = 0;
+    };
+
+    /// @brief Estado de uma thread: a syscall anterior e as sequências em andamento.
+    struct ThreadState
+    {
+        Kind previous = Kind::None;
+        /// @brief O descritor da syscall anterior (aberto pelo open, ou usado pelo lseek).
+        long long previous_fd = -1;
+        /// @brief Quantidade de chamadas pequenas seguidas em cada descritor.
+        std::map<long long, std::size_t> tiny_streaks;
+        std::size_t poll_streak = 0;
+        /// @brief Saída do último poll sem espera, para separar um laço de chamadas esparsas.
+        std::uint64_t last_poll_ns = 0;
+        /// @brief Se o poll em andamento foi chamado sem espera; lido na entrada.
+        bool zero_timeout = false;
+    };
+
+    /// @brief Contagem de chamadas dentro de uma janela de um segundo.
+    struct RateWindow
+    {
+        std::uint64_t second = 0;
+        std::size_t calls = 0;
+    };
+
+    /// @brief Estado de um processo: caminhos consultados e as janelas de taxa.
+    struct ProcessState
+    {
+        std::map<std::string, std::size_t> lookups;
+        RateWindow memory;
+        RateWindow sync;
+    };
+
+    /// @brief Acumulado de um padrão.
+    struct PatternStats
+    {
+        std::size_t calls = 0;
+        std::size_t instances = 0;
+        std::vector<std::string> examples;
+    };
+
+    /**
+     * @brief Registra uma ocorrência de um padrão.
+     * @param calls Quantidade de chamadas envolvidas na ocorrência.
+     * @param new_instance Verdadeiro se a ocorrência inicia uma nova instância (uma sequência,
+     * um caminho, uma janela), o que também a torna candidata a exemplo.
+     */
+    void record(AdvicePattern pattern, const SyscallEvent &event, std::size_t calls,
+                bool new_instance);
+
+    /// @brief O papel de uma syscall, ou Kind::None.
+    Role role_of(long nr) const;
+
+    /// @brief Detecta sequências de E/S pequena no mesmo descritor.
+    void check_tiny_io(ThreadState &thread, const SyscallEvent &event, const Role &role);
+
+    /// @brief Conta as consultas de um caminho e detecta as repetições.
+    void check_lookup(const SyscallEvent &event, const std::string &path);
+
+    /// @brief Diz se um poll/select foi chamado sem espera. Só vale na entrada da syscall.
+    static bool zero_timeout(const SyscallEvent &event, const Role &role);
+
+    /// @brief Detecta sequências de poll sem espera e sem eventos.
+    void check_poll(ThreadState &thread, const SyscallEvent &event);
+
+    /// @brief Conta uma chamada na janela de taxa e detecta o excesso.
+    void check_rate(RateWindow &window, AdvicePattern pattern, std::size_t limit,
+                    const SyscallEvent &event);
+
+    std::vector<Role> m_role_by_nr;
+    std::map<pid_t, ThreadState> m_threads;
+    std::map<pid_t, ProcessState> m_processes;
+    std::array<PatternStats, static_cast<std::size_t>(AdvicePattern::Count)> m_patterns;
+    ProcMaps m_maps;
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "TraceSink.h" // Headers do projeto
+
+#include <cstddef> // Utilizado pelo tipo size_t
+#include <fstream> // Utilizado pelo arquivo de payloads
+#include <map>     // Utilizado pelas cópias de entrada que aguardam o filtro
+#include <set>     // Utilizado pelo conjunto de syscalls capturadas
+#include <string>  // Utilizado pelos nomes de syscalls e caminhos
+#include <vector>  // Utilizado pelo buffer de cópia reutilizável
+
+/**
+ * @class PayloadCapture
+ * @brief Copia o conteúdo dos buffers de dados de read/write/send/recv para um arquivo à parte.
+ *
+ * O conteúdo é copiado com process_vm_readv e anexado a um arquivo binário bruto. O evento da
+ * syscall guarda apenas o deslocamento e o tamanho da cópia nesse arquivo. Chamadas de escrita
+ * são copiadas na entrada, e chamadas de leitura na saída, limitadas pelo valor de retorno. Toda
+ * cópia é limitada a um máximo de bytes por chamada.
+ */
+class PayloadCapture
+{
+  public:
+    /// @brief Descreve onde fica o buffer de dados de uma syscall.
+    struct DataBuffer
+    {
+        /// @brief Índice do argumento com o endereço do buffer (ou do vetor de iovec).
+        int buf_arg;
+        /// @brief Índice do argumento com o tamanho do buffer (ou a quantidade de iovec).
+        int len_arg;
+        /// @brief Verdadeiro se o buffer é escrito pelo kernel (leituras), falso se é lido.
+        bool kernel_writes;
+        /// @brief Verdadeiro se o argumento é um vetor de struct iovec (readv/writev).
+        bool is_iovec;
+        /// @brief Índice do argumento com as flags RWF_* (preadv2/pwritev2), ou -1.
+        int flags_arg;
+    };
+
+    /**
+     * @brief Procura a descrição do buffer de dados de uma syscall.
+     * @param nr O número da syscall.
+     * @return A descrição, ou nullptr se a syscall não transfere dados por um buffer.
+     */
+    static const DataBuffer *find_data_buffer(long nr);
+
+    /**
+     * @brief Diz se o buffer de uma chamada é copiado na saída, limitado pelo valor de retorno.
+     * @return Verdadeiro para leituras e para escritas que podem não consumir o buffer.
+     */
+    static bool captures_at_exit(const SyscallEvent &event, const DataBuffer &desc);
+
+    /**
+     * @brief Interpreta a especificação "<syscalls>:<max-bytes>" da linha de comando.
+     * @param spec A especificação, ex: "read,write,sendto:4096".
+     * @param nrs Recebe os números das syscalls pedidas.
+     * @param max_bytes Recebe o limite de bytes por chamada.
+     * @param error Recebe a descrição do problema, se houver.
+     * @return Verdadeiro se a especificação é válida.
+     */
+    static bool parse_spec(const std::string &spec, std::set<long> &nrs, std::size_t &max_bytes,
+                           std::string &error);
+
+    /**
+     * @brief Abre o arquivo de payloads.
+     * @param nrs As syscalls cujos buffers serão capturados.
+     * @param max_bytes O limite de bytes copiados por chamada.
+     * @param path O caminho do arquivo de payloads.
+     */
+    PayloadCapture(std::set<long> nrs, std::size_t max_bytes, const std::string &path);
+
+    /**
+     * @brief Captura o buffer de uma syscall de escrita na sua parada de entrada.
+     * @param event O evento da chamada; recebe o deslocamento e o tamanho da cópia.
+     * @param defer Guarda a cópia em memória, sem gravá-la, até commit_entry() ou discard_entry().
+     * Usado quando o filtro só decide a chamada na saída.
+     */
+    void capture_entry(SyscallEvent &event, bool defer = false);
+
+    /**
+     * @brief Grava a cópia de entrada guardada para a thread, se houver.
+     * @param event O evento da chamada; recebe o deslocamento e o tamanho da cópia.
+     */
+    void commit_entry(SyscallEvent &event);
+
+    /// @brief Descarta a cópia de entrada guardada para a thread, se houver.
+    void discard_entry(pid_t tid);
+
+    /**
+     * @brief Captura o buffer de uma syscall de leitura na sua parada de saída.
+     * @param event O evento da chamada; recebe o deslocamento e o tamanho da cópia.
+     */
+    void capture_exit(SyscallEvent &event);
+
+  private:
+    /**
+     * @brief Copia até 'limit' bytes do buffer descrito para m_buffer.
+     * @param event O evento da chamada.
+     * @param desc A descrição do buffer da syscall.
+     * @param limit A quantidade de bytes disponível no buffer.
+     * @return A quantidade de bytes copiados.
+     */
+    std::size_t copy(const SyscallEvent &event, const DataBuffer &desc, unsigned long long limit);
+
+    /// @brief Anexa os bytes ao arquivo e guarda o deslocamento e o tamanho no evento.
+    void append(SyscallEvent &event, const char *data, std::size_t size);
+
+    /// @brief Números de syscalls selecionadas, indexados diretamente para o caminho quente.
+    std::vector<bool> m_enabled;
+    std::size_t m_max_bytes;
+    std::ofstream m_file;
+    /// @brief Próximo deslocamento livre no arquivo de payloads.
+    std::uint64_t m_offset = 0;
+    /// @brief Buffer local reutilizado em todas as cópias.
+    std::vector<char> m_buffer;
+    /// @brief Cópias de entrada que aguardam a decisão do filtro na saída, por thread.
+    std::map<pid_t, std::vector<char>> m_pending;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint> // Utilizado pelos endereços
+#include <map>     // Utilizado pelo cache de mapeamentos por processo e de módulos por caminho
+#include <string>  // Utilizado pelos caminhos dos módulos
+#include <vector>  // Utilizado pela lista de mapeamentos
+
+#include <sys/types.h> // Utilizado pelo tipo pid_t
+
+/**
+ * @class ProcMaps
+ * @brief Traduz endereços de um processo rastreado para "módulo+deslocamento" ou
+ * "módulo!símbolo+deslocamento".
+ *
+ * Lê o /proc/[pid]/maps e guarda os mapeamentos por processo: os com nome (arquivos e regiões
+ * como [heap] e [stack]) e também os anônimos, para que endereços já vistos como anônimos não
+ * façam o arquivo ser lido de novo. Só um endereço fora de todos os mapeamentos conhecidos causa
+ * uma nova leitura, já que o processo pode ter carregado bibliotecas ou criado mapeamentos depois
+ * da última. O cache de um processo deve ser descartado no exec.
+ *
+ * Para arquivos ELF o deslocamento é o endereço virtual do próprio arquivo (o mesmo do nm e do
+ * addr2line), calculado pelos segmentos PT_LOAD, e o símbolo vem da .symtab ou, em bibliotecas
+ * sem ela, da .dynsym. Os dados de cada arquivo são lidos uma única vez.
+ */
+class ProcMaps
+{
+  public:
+    /**
+     * @brief Traduz um endereço.
+     * @param pid O PID do processo.
+     * @param addr O endereço no espaço do processo.
+     * @return "libc.so.6!write+0x14" para endereços cobertos por um símbolo,
+     * "libc.so.6+0x11a3c4" para os demais endereços em arquivos mapeados, "[heap]+0x2a0" para
+     * regiões com nome, ou o endereço em hexadecimal se ele está em memória anônima sem nome.
+     */
+    std::string resolve(pid_t pid, std::uint64_t addr);
+
+    /// @brief Descarta o cache de um processo (após um exec ou o seu término).
+    void forget(pid_t pid);
+
+  private:
+    /// @brief Um mapeamento com nome.
+    struct Mapping
+    {
+        std::uint64_t start;
+        std::uint64_t end;
+        /// @brief O endereço dentro do módulo que corresponde a 'start'.
+        std::uint64_t base;
+        /// @brief O nome do arquivo, sem o diretório, ou o nome da região ("[heap]"); vazio para
+        /// memória anônima sem nome.
+        std::string module;
+        /// @brief O caminho completo do arquivo; vazio para regiões.
+        std::string path;
+    };
+
+    /// @brief Um símbolo de função ou de dados de um arquivo ELF.
+    struct Symbol
+    {
+        std::uint64_t value;
+        std::uint64_t size;
+        std::string name;
+    };
+
+    /// @brief Um segmento PT_LOAD de um arquivo ELF.
+    struct Segment
+    {
+        std::uint64_t offset;
+        std::uint64_t vaddr;
+        std::uint64_t file_size;
+        std::uint64_t mem_size;
+    };
+
+    /// @brief Os dados de um arquivo ELF usados na tradução.
+    struct Module
+    {
+        std::vector<Segment> loads;
+        /// @brief Símbolos ordenados pelo endereço.
+        std::vector<Symbol> symbols;
+    };
+
+    /// @brief Procura o mapeamento que contém o endereço.
+    static const Mapping *find(const std::vector<Mapping> &maps, std::uint64_t addr);
+
+    /// @brief Lê os mapeamentos com nome do processo.
+    std::vector<Mapping> load(pid_t pid);
+
+    /// @brief Retorna os dados do arquivo ELF, lendo-os na primeira vez.
+    const Module &module(const std::string &path);
+
+    /// @brief Lê os segmentos e a tabela de símbolos de um arquivo ELF de 64 bits.
+    static Module read_elf(const std::string &path);
+
+    std::map<pid_t, std::vector<Mapping>> m_maps;
+    std::map<std::string, Module> m_modules;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef> // Utilizado pelo tipo size_t
+#include <string>  // Utilizado pelas strings lidas do processo
+
+#include <sys/types.h> // Utilizado pelo tipo pid_t
+#include <sys/uio.h>   // Utilizado pela struct iovec
+
+/**
+ * @brief Funções para ler a memória de um processo rastreado.
+ * Todas as leituras usam process_vm_readv, que copia um bloco inteiro com uma única syscall em
+ * vez de uma palavra por vez como o PTRACE_PEEKDATA.
+ */
+namespace ProcessMemory
+{
+/**
+ * @brief Lê uma string terminada por nulo da memória de um processo rastreado.
+ * @param pid O PID do processo alvo.
+ * @param addr O endereço de memória da string no processo alvo.
+ * @return A string lida do processo entre aspas, "NULL" ou "..." se a string for truncada.
+ */
+std::string read_string(pid_t pid, unsigned long addr);
+
+/**
+ * @brief Copia um bloco contínuo de memória de um processo rastreado.
+ * @param pid O PID do processo alvo.
+ * @param addr O endereço inicial do bloco no processo alvo.
+ * @param buf O buffer local de destino.
+ * @param len A quantidade máxima de bytes a copiar.
+ * @return A quantidade de bytes efetivamente copiados (0 em caso de erro).
+ */
+std::size_t read(pid_t pid, unsigned long addr, void *buf, std::size_t len);
+
+/**
+ * @brief Copia uma lista de blocos do processo rastreado para um buffer local contínuo.
+ * @param pid O PID do processo alvo.
+ * @param remote Os blocos no processo alvo, já limitados ao tamanho desejado.
+ * @param count A quantidade de blocos.
+ * @param buf O buffer local de destino.
+ * @param len O tamanho do buffer local.
+ * @return A quantidade de bytes efetivamente copiados (0 em caso de erro).
+ */
+std::size_t readv(pid_t pid, const iovec *remote, std::size_t count, void *buf, std::size_t len);
+} // namespace ProcessMemory
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "TraceSink.h" // Headers do projeto
+
+#include <cstddef>       // Utilizado pela quantidade de itens do relatório
+#include <cstdint>       // Utilizado pelos instantes em nanossegundos e tempos de CPU
+#include <string>        // Utilizado pela linha de comando de cada processo
+#include <unordered_map> // Utilizado pelo índice dos processos vivos
+#include <vector>        // Utilizado pelos nós da árvore
+
+/**
+ * @class ProcessTreeProfiler
+ * @brief Monta a árvore de processos de builds e pipelines em lote e aponta o caminho crítico e
+ * as subárvores mais lentas.
+ *
+ * Usa só os eventos de processo: o fork cria o nó, o exec guarda a linha de comando (lida uma vez
+ * do /proc/[pid]/cmdline) e o PTRACE_EVENT_EXIT de cada thread soma o tempo de CPU de usuário e
+ * de sistema, lido uma vez do /proc/[pid]/task/[tid]/stat. Como não usa syscalls, as threads
+ * rodam sem paradas de syscall quando nenhuma outra análise precisa delas.
+ *
+ * Cada processo ocupa um nó de tamanho fixo mais a linha de comando (truncada), e os nós ficam em
+ * um vetor na ordem de criação, então a árvore é percorrida sem ponteiros e um PID reutilizado
+ * vira um nó novo.
+ */
+class ProcessTreeProfiler : public TraceSink
+{
+  public:
+    /**
+     * @brief Constrói o perfil.
+     * @param top Quantidade de subárvores e de comandos listados no relatório.
+     */
+    explicit ProcessTreeProfiler(std::size_t top);
+
+    bool wants_syscalls() const override
+    {
+        return false;
+    }
+
+    /// @brief O tempo de CPU de cada thread é lido do /proc na parada PTRACE_EVENT_EXIT.
+    bool wants_exit_stops() const override
+    {
+        return true;
+    }
+
+    /// @brief Nenhuma syscall é usada, mesmo quando outro consumidor faz o Tracer pará-las.
+    CaptureLevel on_syscall_entry(const SyscallEvent &) override
+    {
+        return CaptureLevel::Skip;
+    }
+
+    void on_syscall_exit(const SyscallEvent &) override
+    {
+    }
+
+    void on_process_event(const ProcessEvent &event) override;
+
+    /// @brief Calcula as subárvores e registra o caminho crítico e o relatório.
+    void on_finish() override;
+
+  private:
+    /// @brief Marca a ausência de pai.
+    static constexpr std::uint32_t kNone = UINT32_MAX;
+
+    /// @brief Um processo da árvore.
+    struct Node
+    {
+        pid_t pid = 0;
+        /// @brief Índice do pai em m_nodes, ou kNone para as raízes.
+        std::uint32_t parent = kNone;
+        /// @brief Threads criadas com clone, além da principal.
+        std::uint32_t threads = 0;
+        std::uint32_t execs = 0;
+        /// @brief O status do waitpid do término da thread principal.
+        int status = 0;
+        std::uint64_t start_ns = 0;
+        /// @brief O último exec; zero se o processo não executou outro programa.
+        std::uint64_t exec_ns = 0;
+        /// @brief Término da thread principal; zero se ainda estava rodando no fim.
+        std::uint64_t end_ns = 0;
+        /// @brief Tempo de CPU das threads que já terminaram, em ticks do relógio (CLK_TCK).
+        std::uint64_t utime = 0;
+        std::uint64_t stime = 0;
+        /// @brief A linha de comando do último exec, ou a herdada do pai.
+        std::string argv;
+    };
+
+    /**
+     * @brief Retorna o nó vivo de um processo, criando-o se ele ainda não é conhecido.
+     * @param pid O PID do processo.
+     * @param ts_ns O instante do evento, usado se o início não puder ser lido.
+     * @return O índice do nó em m_nodes.
+     */
+    std::uint32_t node(pid_t pid, std::uint64_t ts_ns);
+
+    std::size_t m_top;
+    std::vector<Node> m_nodes;
+    /// @brief O nó de cada processo ainda vivo.
+    std::unordered_map<pid_t, std::uint32_t> m_live;
+    /// @brief Instantes do primeiro e do último evento, para o relatório.
+    std::uint64_t m_first_ns = 0;
+    std::uint64_t m_last_ns = 0;
+    /// @brief Ticks por segundo dos tempos de CPU do /proc.
+    long m_ticks_per_second;
+};
@@ -1,8 +1,10 @@
 #pragma once
 
-#include <map>    // Utilizado para o mapa de chamadas de sistema
-#include <string> // Utilizado para as strings de nomes e tipos de argumentos das chamadas de sistema
-#include <vector> // Utilizado para os vetores dos argumentos das chamadas de sistema
+#include <cstddef> // Utilizado pelo tamanho das tabelas por nome
+#include <map>     // Utilizado para o mapa de chamadas de sistema
+#include <string>  // Utilizado para as strings de nomes e tipos de argumentos das chamadas de sistema
+#include <utility> // Utilizado pelos pares {nome, valor} das tabelas por nome
+#include <vector>  // Utilizado para os vetores dos argumentos das chamadas de sistema
 
 /**
  * @brief Define estruturas e funções para recuperar informações de chamadas de sistema.
@@ -50,4 +52,43 @@ inline const SyscallInfo *get_syscall_info(long number)
     // Retorna nullptr se o número da syscall não estiver no mapa.
     return nullptr;
 }
+
+/**
+ * @brief Procura o número de uma chamada de sistema pelo seu nome.
+ * @param name O nome da chamada de sistema (ex: "openat").
+ * @return O número da syscall, ou -1 se o nome não for conhecido.
+ */
+inline long find_syscall_number(const std::string &name)
+{
+    for (const auto &[nr, info] : g_syscall_map)
+    {
+        if (info.name == name)
+        {
+            return nr;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Converte uma tabela por nome de syscall em um vetor indexado pelo número, para ser
+ * consultado no caminho quente sem comparar strings.
+ * @param table Os pares {nome, valor}. Nomes que não existem nesta arquitetura são ignorados.
+ * @param fallback O valor das syscalls que não estão na tabela.
+ * @return Um vetor com uma posição para cada número até o maior conhecido.
+ */
+template <typename T, std::size_t N>
+std::vector<T> table_by_number(const std::pair<const char *, T> (&table)[N], const T &fallback)
+{
+    std::vector<T> out(g_syscall_map.empty() ? 0 : g_syscall_map.rbegin()->first + 1, fallback);
+    for (const auto &[name, value] : table)
+    {
+        long nr = find_syscall_number(name);
+        if (nr >= 0)
+        {
+            out[nr] = value;
+        }
+    }
+    return out;
+}
 } // namespace Syscall
\ No newline at end of file
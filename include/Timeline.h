@@ -0,0 +1,77 @@
+#pragma once
+
+#include "TraceSink.h" // Headers do projeto
+
+#include <map>    // Utilizado pelos fluxos pendentes de cada thread
+#include <memory> // Utilizado pelo std::unique_ptr retornado pela fábrica
+#include <set>    // Utilizado pelos processos e threads já descritos
+#include <string> // Utilizado pelos nomes e caminhos
+
+/**
+ * @class TimelineExporter
+ * @brief Exporta as syscalls como fatias de duração em uma linha do tempo por thread.
+ *
+ * Cada thread ganha sua própria trilha, agrupada sob a trilha do seu processo. Os eventos de
+ * fork, vfork, clone e exec viram eventos instantâneos ligados por setas de fluxo, do processo pai
+ * até o filho e do filho até o seu exec. A escrita é feita em streaming, então o arquivo pode
+ * crescer sem que o Tracer guarde os eventos em memória.
+ *
+ * As subclasses implementam apenas o formato de saída: o protobuf binário do Perfetto ou o JSON
+ * de eventos do Chrome.
+ */
+class TimelineExporter : public TraceSink
+{
+  public:
+    /**
+     * @brief Cria o exportador adequado à extensão do arquivo.
+     * @param path O caminho de saída. Arquivos ".json" usam o formato JSON do Chrome; os demais
+     * usam o formato protobuf do Perfetto.
+     * @return O exportador, ou nullptr se o arquivo não pôde ser aberto.
+     */
+    static std::unique_ptr<TimelineExporter> create(const std::string &path);
+
+    void on_syscall_exit(const SyscallEvent &event) override;
+    void on_process_event(const ProcessEvent &event) override;
+    void on_finish() override;
+
+  protected:
+    /// @brief Descreve (ou renomeia) a trilha de um processo.
+    virtual void write_process(pid_t pid, const std::string &name) = 0;
+
+    /// @brief Descreve a trilha de uma thread dentro da trilha do seu processo.
+    virtual void write_thread(pid_t pid, pid_t tid, const std::string &name) = 0;
+
+    /// @brief Escreve uma fatia de duração na trilha de uma thread.
+    virtual void write_slice(pid_t pid, pid_t tid, const std::string &name,
+                             std::uint64_t begin_ns, std::uint64_t end_ns,
+                             const std::string &args, long long ret) = 0;
+
+    /// @brief Posição de um evento instantâneo dentro de uma seta de fluxo.
+    enum class FlowPhase
+    {
+        Begin, ///< Origem da seta (o fork no processo pai).
+        Step,  ///< Ponto intermediário (o início do filho).
+        End    ///< Destino final (o exec do filho).
+    };
+
+    /**
+     * @brief Escreve um evento instantâneo que participa de uma seta de fluxo.
+     * @param flow_id O identificador do fluxo; zero se o evento não pertence a nenhum fluxo.
+     * @param phase A posição do evento no fluxo.
+     */
+    virtual void write_instant(pid_t pid, pid_t tid, const std::string &name, std::uint64_t ts_ns,
+                               std::uint64_t flow_id, FlowPhase phase) = 0;
+
+    /// @brief Finaliza o arquivo de saída.
+    virtual void close() = 0;
+
+  private:
+    /// @brief Garante que as trilhas do processo e da thread já foram descritas.
+    void ensure_track(pid_t pid, pid_t tid);
+
+    std::set<pid_t> m_known_processes;
+    std::set<pid_t> m_known_threads;
+    /// @brief O fluxo iniciado no fork de cada filho, encerrado no seu exec.
+    std::map<pid_t, std::uint64_t> m_open_flows;
+    std::uint64_t m_next_flow_id = 1;
+};
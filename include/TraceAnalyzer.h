@@ -0,0 +1,125 @@
+#pragma once
+
+#include "TraceRecord.h" // Headers do projeto
+
+#include <cstddef>       // Utilizado pelo tipo size_t
+#include <cstdint>       // Utilizado pelos contadores
+#include <map>           // Utilizado pela contagem de errno de cada syscall
+#include <ostream>       // Utilizado pela saída do relatório
+#include <string>        // Utilizado pelos caminhos e mensagens de erro
+#include <sys/types.h>   // Utilizado pelo tipo pid_t
+#include <unordered_map> // Utilizado pelas estatísticas por processo
+#include <vector>        // Utilizado pelos baldes do histograma e pelas estatísticas por syscall
+
+/**
+ * @class LatencyHistogram
+ * @brief Histograma log-linear de latências em nanossegundos.
+ *
+ * Cada potência de dois é dividida em 16 baldes iguais, então os percentis têm erro relativo de
+ * no máximo 1/16. Os baldes são fixos, o que torna a junção de dois histogramas uma soma balde a
+ * balde: é isso que permite calcular os percentis em paralelo e juntar os resultados no final.
+ */
+class LatencyHistogram
+{
+  public:
+    /// @brief Registra uma latência.
+    void add(std::uint64_t ns);
+
+    /// @brief Soma os baldes de outro histograma a este.
+    void merge(const LatencyHistogram &other);
+
+    /**
+     * @brief Calcula um percentil.
+     * @param quantile O percentil entre 0 e 1 (ex: 0.99).
+     * @return O limite superior do balde que contém o percentil, em nanossegundos.
+     */
+    std::uint64_t percentile(double quantile) const;
+
+  private:
+    static constexpr unsigned kSubBits = 4;
+    static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBits;
+    static constexpr std::size_t kBucketCount = (64 - kSubBits + 1) * kSubBuckets;
+
+    static std::size_t bucket_of(std::uint64_t ns);
+    static std::uint64_t bucket_upper(std::size_t bucket);
+
+    /// @brief Alocado no primeiro registro, para que syscalls não vistas não ocupem memória.
+    std::vector<std::uint64_t> m_buckets;
+    std::uint64_t m_count = 0;
+};
+
+/**
+ * @struct SyscallStats
+ * @brief Estatísticas acumuladas de uma syscall.
+ */
+struct SyscallStats
+{
+    std::uint64_t count = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t total_ns = 0;
+    std::uint64_t max_ns = 0;
+    LatencyHistogram latency;
+    /// @brief Quantidade de falhas por errno.
+    std::map<int, std::uint64_t> errnos;
+};
+
+/**
+ * @struct ProcessStats
+ * @brief Estatísticas acumuladas de um processo (TGID).
+ */
+struct ProcessStats
+{
+    std::uint64_t count = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t total_ns = 0;
+};
+
+/**
+ * @struct TraceStats
+ * @brief O resultado parcial (de um bloco) ou final (do arquivo inteiro) da análise.
+ */
+struct TraceStats
+{
+    std::uint64_t records = 0;
+    std::uint64_t first_ns = UINT64_MAX;
+    std::uint64_t last_ns = 0;
+    /// @brief Indexado pelo número da syscall.
+    std::vector<SyscallStats> syscalls;
+    std::unordered_map<pid_t, ProcessStats> processes;
+
+    /// @brief Acumula um registro (a etapa "map").
+    void add(const TraceRecord &record);
+
+    /// @brief Junta outro resultado parcial a este (a etapa "reduce").
+    void merge(const TraceStats &other);
+};
+
+/**
+ * @brief Análise paralela de arquivos gravados com --record.
+ *
+ * O arquivo é mapeado em memória e dividido em blocos alinhados aos registros. Cada thread de
+ * trabalho pega blocos de uma fila compartilhada e os acumula no seu próprio TraceStats, sem
+ * nenhum estado compartilhado além do índice do próximo bloco. No final os resultados parciais
+ * são juntados. Como os histogramas têm baldes fixos, os percentis do arquivo inteiro são exatos
+ * em relação aos baldes, independentemente de como o arquivo foi dividido.
+ */
+namespace TraceAnalyzer
+{
+/**
+ * @brief Analisa um arquivo de gravação.
+ * @param path O caminho do arquivo.
+ * @param threads A quantidade de threads de trabalho.
+ * @param result Recebe as estatísticas do arquivo inteiro.
+ * @param error Recebe a descrição do erro, se houver.
+ * @return Verdadeiro se o arquivo foi lido.
+ */
+bool analyze(const std::string &path, unsigned threads, TraceStats &result, std::string &error);
+
+/**
+ * @brief Escreve o relatório de texto.
+ * @param stats As estatísticas do arquivo.
+ * @param top Quantidade máxima de linhas das tabelas de processos e de erros.
+ * @param out A saída do relatório.
+ */
+void print_report(const TraceStats &stats, std::size_t top, std::ostream &out);
+} // namespace TraceAnalyzer
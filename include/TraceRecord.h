@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint> // Utilizado pelos tipos de tamanho fixo do formato
+
+/**
+ * @brief Formato binário das gravações de syscalls, lido pelo TracerC-analyze.
+ *
+ * O arquivo começa com um TraceFileHeader seguido de registros TraceRecord de tamanho fixo, na
+ * ordem em que as syscalls terminaram. O tamanho fixo permite dividir o arquivo em blocos
+ * independentes só com aritmética, sem precisar ler o arquivo para achar as fronteiras. Os campos
+ * estão na ordem de bytes da máquina que gravou.
+ */
+namespace TraceRecordFormat
+{
+/// @brief Identifica um arquivo de gravação do TracerC.
+inline constexpr char kMagic[8] = {'T', 'R', 'C', 'R', 'E', 'C', '\0', '\0'};
+/// @brief Versão atual do formato.
+inline constexpr std::uint32_t kVersion = 1;
+} // namespace TraceRecordFormat
+
+/**
+ * @struct TraceFileHeader
+ * @brief Cabeçalho do arquivo de gravação.
+ */
+struct TraceFileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    /// @brief Tamanho de cada registro, para que leitores reconheçam registros estendidos.
+    std::uint32_t record_size;
+};
+
+/**
+ * @struct TraceRecord
+ * @brief Uma syscall completa (entrada e saída).
+ */
+struct TraceRecord
+{
+    std::uint64_t entry_ns;
+    std::uint64_t exit_ns;
+    /// @brief O valor de retorno; valores entre -4095 e -1 são um errno negado.
+    std::int64_t ret;
+    std::int32_t tid;
+    std::int32_t pid;
+    std::int32_t nr;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(TraceFileHeader) == 16, "o cabeçalho faz parte do formato em disco");
+static_assert(sizeof(TraceRecord) == 40, "o registro faz parte do formato em disco");
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "TraceRecord.h" // Headers do projeto
+#include "TraceSink.h"   // Headers do projeto
+
+#include <fstream> // Utilizado pelo arquivo de gravação
+#include <string>  // Utilizado pelo caminho do arquivo
+#include <vector>  // Utilizado pelo bloco de registros pendentes
+
+/**
+ * @class TraceRecorder
+ * @brief Grava cada syscall como um registro binário de tamanho fixo (ver TraceRecord.h).
+ *
+ * Os registros são acumulados em blocos e escritos de uma vez, então o custo por syscall é uma
+ * cópia de 40 bytes. O arquivo gerado é analisado depois, fora da máquina rastreada, pelo
+ * TracerC-analyze.
+ */
+class TraceRecorder : public TraceSink
+{
+  public:
+    /**
+     * @brief Abre o arquivo e escreve o cabeçalho.
+     * @param path O caminho do arquivo de gravação.
+     */
+    explicit TraceRecorder(const std::string &path);
+
+    /// @brief Os registros têm tamanho fixo e guardam só os campos crus do evento.
+    CaptureLevel on_syscall_entry(const SyscallEvent &) override
+    {
+        return CaptureLevel::Event;
+    }
+
+    void on_syscall_exit(const SyscallEvent &event) override;
+
+    /// @brief Escreve o último bloco pendente.
+    void on_finish() override;
+
+  private:
+    /// @brief Escreve os registros pendentes no arquivo.
+    void flush();
+
+    std::ofstream m_file;
+    std::vector<TraceRecord> m_block;
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint> // Utilizado pelos timestamps em nanossegundos
+#include <string>  // Utilizado pelos argumentos já formatados
+
+#include <sys/types.h> // Utilizado pelo tipo pid_t
+
+/**
+ * @struct SyscallEvent
+ * @brief Representa uma chamada de sistema de uma thread rastreada, da entrada até a saída.
+ *
+ * O evento é preenchido na parada de entrada (número, argumentos e timestamp) e completado na
+ * parada de saída (valor de retorno e timestamp de saída).
+ */
+struct SyscallEvent
+{
+    /// @brief O TID da thread que fez a chamada de sistema.
+    pid_t tid = 0;
+    /// @brief O PID (tgid) do processo ao qual a thread pertence.
+    pid_t pid = 0;
+    /// @brief O número da chamada de sistema (registrador 'orig_rax').
+    long nr = -1;
+    /// @brief Os 6 argumentos crus, na ordem da ABI x86-64 (rdi, rsi, rdx, r10, r8, r9).
+    unsigned long long args[6] = {};
+    /// @brief O endereço da instrução logo após o 'syscall' (registrador 'rip' na entrada),
+    /// normalmente dentro do wrapper da libc que fez a chamada.
+    std::uint64_t ip = 0;
+    /// @brief O valor de retorno (registrador 'rax'). Só é válido depois da parada de saída.
+    long long ret = 0;
+    /// @brief Instante da parada de entrada, em nanossegundos de um relógio monotônico.
+    std::uint64_t entry_ns = 0;
+    /// @brief Instante da parada de saída, em nanossegundos do mesmo relógio.
+    std::uint64_t exit_ns = 0;
+    /// @brief Os argumentos formatados para leitura humana, lidos no momento da entrada.
+    std::string args_str;
+    /// @brief Deslocamento do conteúdo do buffer de dados no arquivo de payloads.
+    std::uint64_t payload_offset = 0;
+    /// @brief Tamanho do conteúdo copiado; zero quando nada foi capturado.
+    std::uint32_t payload_len = 0;
+};
+
+/**
+ * @brief Tipos de eventos de ciclo de vida de processos e threads.
+ */
+enum class ProcessEventType
+{
+    Fork,  ///< Um processo novo criado com fork.
+    Vfork, ///< Um processo novo criado com vfork.
+    Clone, ///< Uma thread (ou processo) nova criada com clone.
+    Exec,    ///< Um processo executou um novo programa com execve.
+    Exit,    ///< Uma thread terminou (saiu ou foi encerrada por um sinal).
+    Exiting  ///< Uma thread está terminando (PTRACE_EVENT_EXIT); o /proc dela ainda existe. Só
+             ///< é gerado se algum consumidor pedir (ver TraceSink::wants_exit_stops).
+};
+
+/**
+ * @struct ProcessEvent
+ * @brief Um evento de ciclo de vida observado pelas paradas PTRACE_EVENT_* e de término.
+ */
+struct ProcessEvent
+{
+    ProcessEventType type = ProcessEventType::Exit;
+    /// @brief A thread que gerou o evento (a que chamou fork/clone/execve, ou a que terminou).
+    pid_t tid = 0;
+    /// @brief O PID (tgid) do processo dessa thread.
+    pid_t pid = 0;
+    /// @brief A thread criada, em eventos Fork, Vfork e Clone.
+    pid_t child_tid = 0;
+    /// @brief O PID (tgid) do processo da thread criada.
+    pid_t child_pid = 0;
+    /// @brief O status do waitpid, em eventos Exit e Exiting.
+    int status = 0;
+    /// @brief Instante do evento, no mesmo relógio dos eventos de syscall.
+    std::uint64_t ts_ns = 0;
+};
+
+/**
+ * @brief O quanto de uma chamada de sistema um consumidor precisa, decidido na entrada.
+ */
+enum class CaptureLevel
+{
+    Skip,   ///< O consumidor não quer esta chamada; on_syscall_exit não será chamado para ela.
+    Event,  ///< Só o evento tipado: número, argumentos crus, retorno e timestamps.
+    Decoded ///< Também os argumentos formatados em args_str, o que lê a memória do processo.
+};
+
+/**
+ * @class TraceSink
+ * @brief Interface para consumidores dos eventos produzidos pelo loop do Tracer.
+ *
+ * Cada análise opcional (relatórios, exportadores, etc.) implementa esta interface e é
+ * notificada pelo Tracer sem precisar conhecer os detalhes do ptrace.
+ */
+class TraceSink
+{
+  public:
+    virtual ~TraceSink() = default;
+
+    /**
+     * @brief Chamado na entrada de uma chamada de sistema, antes de qualquer leitura de memória.
+     * @param event O evento com tid, pid, nr, args, ip e entry_ns preenchidos.
+     * @return O quanto da chamada o consumidor precisa. O Tracer só formata os argumentos e só
+     * para na saída quando algum consumidor (ou o log) precisa.
+     */
+    virtual CaptureLevel on_syscall_entry(const SyscallEvent & /*event*/)
+    {
+        return CaptureLevel::Decoded;
+    }
+
+    /**
+     * @brief Diz se o consumidor usa eventos de syscall.
+     * @return Falso para consumidores só de eventos de processo. Se nenhum consumidor (nem o log)
+     * usa syscalls, as threads rodam sem paradas de syscall, e só os eventos de processo param.
+     */
+    virtual bool wants_syscalls() const
+    {
+        return true;
+    }
+
+    /**
+     * @brief Diz se o consumidor usa eventos Exiting.
+     * @return Verdadeiro para consumidores que leem o /proc de uma thread antes do término. Sem
+     * nenhum, o Tracer não pede PTRACE_O_TRACEEXIT e cada término custa uma parada a menos.
+     */
+    virtual bool wants_exit_stops() const
+    {
+        return false;
+    }
+
+    /**
+     * @brief Chamado quando uma chamada de sistema retorna.
+     * @param event O evento completo, com entrada e saída preenchidas.
+     */
+    virtual void on_syscall_exit(const SyscallEvent &event) = 0;
+
+    /**
+     * @brief Chamado em eventos de criação, exec e término de processos e threads.
+     * @param event O evento de ciclo de vida.
+     */
+    virtual void on_process_event(const ProcessEvent & /*event*/)
+    {
+    }
+
+    /**
+     * @brief Chamado uma única vez quando o loop de rastreamento termina.
+     */
+    virtual void on_finish()
+    {
+    }
+};
@@ -1,8 +1,92 @@
 #pragma once
 
-#include <map>    // Utilizado para controlar os estados do PTrace das threads
-#include <string> // Utilizado em vários lugares
-#include <vector> // Utilizado nos vetores de PID e argumentos
+#include "ControlChannel.h"   // Headers do projeto
+#include "FilterProgram.h"    // Headers do projeto
+#include "OverheadGovernor.h" // Headers do projeto
+#include "PayloadCapture.h"   // Headers do projeto
+#include "TraceSink.h"        // Headers do projeto
+
+#include <cstddef> // Utilizado pelo tipo size_t nas opções
+#include <cstdint> // Utilizado pela quantidade de slots do anel de eventos
+#include <map>     // Utilizado para controlar os estados do PTrace das threads
+#include <memory>  // Utilizado para guardar os consumidores de eventos
+#include <set>     // Utilizado pelo conjunto de syscalls com payload capturado
+#include <string>  // Utilizado em vários lugares
+#include <vector>  // Utilizado nos vetores de PID e argumentos
+
+/**
+ * @struct TracerOptions
+ * @brief Agrupa as opções de linha de comando que alteram o comportamento do Tracer.
+ */
+struct TracerOptions
+{
+    /// @brief Quantidade de chamadas bloqueantes mais longas listadas no relatório de tempo
+    /// bloqueado. Zero desativa o relatório.
+    std::size_t blocked_report_top = 0;
+
+    /// @brief Quantidade de endereços de futex e de threads listados no relatório de contenção.
+    /// Zero desativa o relatório.
+    std::size_t futex_report_top = 0;
+
+    /// @brief Quantidade de subárvores e de comandos listados no perfil da árvore de processos.
+    /// Zero desativa o perfil.
+    std::size_t process_tree_top = 0;
+
+    /// @brief Syscalls cujos buffers de dados são copiados para o arquivo de payloads. Vazio
+    /// desativa a captura.
+    std::set<long> capture_syscalls;
+    /// @brief Limite de bytes copiados por chamada na captura de payloads.
+    std::size_t capture_max_bytes = 0;
+    /// @brief Caminho do arquivo de payloads.
+    std::string capture_path;
+
+    /// @brief Endereço ("127.0.0.1:<porta>" ou caminho de socket Unix) onde as métricas
+    /// OpenMetrics são servidas. Vazio desativa o exportador.
+    std::string metrics_listen;
+
+    /// @brief Arquivo da linha do tempo (protobuf do Perfetto, ou JSON do Chrome se terminar em
+    /// ".json"). Vazio desativa a exportação.
+    std::string timeline_path;
+
+    /// @brief Procura padrões ineficientes de syscalls e os relata ao final.
+    bool advise = false;
+
+    /// @brief Arquivo binário onde cada syscall é gravada para o TracerC-analyze. Vazio desativa a
+    /// gravação.
+    std::string record_path;
+
+    /// @brief Arquivo CSV da série temporal de memória virtual por processo. Vazio desativa o
+    /// perfil do espaço de endereçamento.
+    std::string memory_profile_path;
+
+    /// @brief Nome do anel de eventos em memória compartilhada ("/<nome>"). Vazio desativa a
+    /// publicação. Se o anel não puder ser criado, o Tracer segue sem ele; quem precisa que a
+    /// falha seja fatal cria o EventRingPublisher, confere valid() e o registra com add_sink().
+    std::string shm_ring_name;
+    /// @brief Quantidade de slots do anel de eventos.
+    std::uint32_t shm_ring_slots = 0;
+
+    /// @brief A expressão de --filter já compilada. Nulo rastreia todos os eventos.
+    std::shared_ptr<const FilterProgram> filter;
+
+    /// @brief Lista de syscalls rastreadas, separadas por vírgula. Vazio rastreia todas.
+    std::string syscall_filter;
+
+    /// @brief Caminho do socket Unix do canal de controle. Vazio desativa o canal.
+    std::string control_path;
+
+    /// @brief Orçamento de paradas do ptrace por segundo; acima dele o rastreamento é estreitado
+    /// (ver OverheadGovernor). Zero desativa o governador.
+    std::uint64_t overhead_budget = 0;
+    /// @brief Permite ao governador amostrar as threads mais ativas (o segundo nível), o que
+    /// pode injetar EINTR nas syscalls bloqueadas delas.
+    bool overhead_sampling = false;
+
+    /// @brief Registra cada syscall no log (SYSCALL_ENTRY/SYSCALL_EXIT). Quem usa a libtracer
+    /// e consome os eventos pelos sinks pode desligar, e então só as chamadas que algum sink
+    /// pede são tratadas.
+    bool log_syscalls = true;
+};
 
 /**
  * @class Tracer
@@ -10,6 +94,9 @@
  *
  * Esta classe encapsula a lógica para se anexar a processos,
  * monitorar suas chamadas de sistema e lidar com eventos de processo como forks e execs.
+ *
+ * É o centro da libtracer: outros programas criam o Tracer com os PIDs de attach_tree() ou de
+ * spawn_traced(), registram os seus consumidores com add_sink() e chamam run().
  */
 class Tracer
 {
@@ -17,8 +104,15 @@ class Tracer
     /**
      * @brief Constrói um objeto Tracer.
      * @param pids Um vetor de PIDs/TIDs iniciais para rastrear.
+     * @param options As opções que ativam as análises opcionais.
+     */
+    explicit Tracer(const std::vector<pid_t> &pids, const TracerOptions &options = {});
+
+    /**
+     * @brief Registra um consumidor de eventos, além dos criados a partir das opções.
+     * @param sink O consumidor. Deve ser registrado antes de run().
      */
-    explicit Tracer(const std::vector<pid_t> &pids);
+    void add_sink(std::unique_ptr<TraceSink> sink);
 
     /**
      * @brief Inicia o loop principal de rastreamento.
@@ -27,21 +121,143 @@ class Tracer
      */
     void run();
 
+    /// @brief Fecha o signalfd usado pelo canal de controle.
+    ~Tracer();
+
+    Tracer(const Tracer &) = delete;
+    Tracer &operator=(const Tracer &) = delete;
+
   private:
+    /// @brief O que fazer quando chegar o SIGSTOP enviado pelo próprio Tracer a uma thread.
+    enum class PendingStop
+    {
+        Attach, ///< Parada inicial de um PTRACE_ATTACH: configurar e começar a rastrear.
+        Resume, ///< Voltar a rastrear as syscalls de uma thread que estava em PTRACE_CONT.
+        Detach  ///< Desanexar a thread.
+    };
+
+    /**
+     * @brief Aguarda a próxima parada de qualquer tracee.
+     * Com o canal de controle ativo, também atende os comandos recebidos enquanto espera.
+     * @param status Recebe o status do waitpid.
+     * @return O PID retornado pelo waitpid.
+     */
+    pid_t wait_for_stop(int &status);
+
+    /**
+     * @brief Deixa o governador fechar a janela e trocar a fase de amostragem, e traz de volta
+     * as threads amostradas que estavam em PTRACE_CONT.
+     * @param now_ns O instante atual.
+     */
+    void tick_governor(std::uint64_t now_ns);
+
+    /**
+     * @brief Executa um comando recebido pelo canal de controle e responde ao cliente.
+     * @param command O comando.
+     */
+    void handle_control_command(const ControlCommand &command);
+
+    /**
+     * @brief Trata a parada de uma thread que aguarda o SIGSTOP enviado pelo Tracer.
+     * @param pid O PID da thread parada.
+     * @param status O status do waitpid.
+     * @return Verdadeiro se a parada foi consumida aqui.
+     */
+    bool handle_pending_stop(pid_t pid, int status);
+
+    /**
+     * @brief Envia um SIGSTOP para uma thread, para tratá-la na próxima parada.
+     * @param tid O TID da thread.
+     * @param action O que fazer quando a parada chegar.
+     */
+    void request_stop(pid_t tid, PendingStop action);
+
+    /**
+     * @brief Resume uma thread parada, com ou sem paradas de syscall conforme o estado de pausa.
+     * @param pid O PID da thread.
+     * @param sig O sinal a ser entregue (0 para nenhum).
+     */
+    void resume_thread(pid_t pid, int sig);
+
+    /**
+     * @brief Anexa um processo e todos os seus descendentes em tempo de execução.
+     * @param pid O PID raiz.
+     * @return A quantidade de threads anexadas.
+     */
+    std::size_t attach_process(pid_t pid);
+
+    /**
+     * @brief Troca o filtro de syscalls.
+     * @param list Lista de nomes separados por vírgula, ou "all".
+     * @param error Recebe a descrição do problema, se houver.
+     * @return Verdadeiro se a lista é válida.
+     */
+    bool set_syscall_filter(const std::string &list, std::string &error);
+
     /**
-     * @brief Registra a entrada de uma chamada de sistema.
+     * @brief Remove uma thread de todos os mapas de estado.
+     * @param pid O PID da thread.
+     */
+    void forget_thread(pid_t pid);
+
+    /**
+     * @brief Avalia o filtro só com o pid e o tid de uma thread recém registrada.
+     * @param pid O TID da thread; o seu tgid já deve estar em m_tgid.
+     *
+     * Se nenhuma syscall da thread pode passar no filtro, ela entra em m_excluded_threads e
+     * passa a ser resumida com PTRACE_CONT.
+     */
+    void classify_thread(pid_t pid);
+
+    /**
+     * @brief Trata uma parada de entrada de syscall, preenchendo o evento pendente da thread.
      * @param pid O PID do processo que fez a chamada de sistema.
+     * @param now_ns O instante da parada.
      */
-    static void log_syscall_entry(pid_t pid);
+    void handle_syscall_entry(pid_t pid, std::uint64_t now_ns);
 
     /**
-     * @brief Registra a saída de uma chamada de sistema.
+     * @brief Trata uma parada de saída de syscall, completando o evento e notificando os sinks.
      * @param pid O PID do processo que fez a chamada de sistema.
+     * @param now_ns O instante da parada.
+     * @param log Se falso, o resultado não é registrado (usado após um execve).
      */
-    static void log_syscall_exit(pid_t pid);
+    void handle_syscall_exit(pid_t pid, std::uint64_t now_ns, bool log);
 
-    /// @brief (Não utilizado) Destinado a armazenar o PID do processo inicial criado com fork.
-    pid_t m_initial_fork_pid = -1;
+    /**
+     * @brief Repassa um evento de ciclo de vida de processo para todos os sinks.
+     * @param event O evento de criação, exec ou término.
+     */
+    void notify_process_event(const ProcessEvent &event);
+
+    /**
+     * @brief Formata e registra a entrada de uma chamada de sistema.
+     * @param event O evento da chamada; seus argumentos formatados são preenchidos aqui.
+     * @param log Falso para apenas formatar, quando o registro depende do filtro na saída.
+     */
+    static void log_syscall_entry(SyscallEvent &event, bool log);
+
+    /**
+     * @brief Registra a saída de uma chamada de sistema.
+     * @param event O evento completo da chamada.
+     * @param entry_payload Verdadeiro se a cópia de entrada só foi gravada na saída (filtro
+     * decidido na saída); a referência ao payload vai então nesta linha.
+     */
+    static void log_syscall_exit(const SyscallEvent &event, bool entry_payload);
+
+    /// @brief As threads iniciais, paradas até o início do run().
+    std::vector<pid_t> m_start_pids;
+
+    /// @brief Registra cada syscall no log.
+    bool m_log_syscalls = true;
+
+    /// @brief Falso quando nem o log nem nenhum consumidor usa syscalls; as threads rodam com
+    /// PTRACE_CONT e só param nos eventos de processo.
+    bool m_syscall_stops = true;
+
+    /// @brief Verdadeiro se algum consumidor usa eventos Exiting; só então as threads param no
+    /// PTRACE_EVENT_EXIT.
+    bool m_exit_stops = false;
 
     /// @brief Rastreia se uma thread está atualmente dentro de uma chamada de sistema (entre a
     /// entrada e a saída). A chave é o PID/TID, e o valor é verdadeiro se estiver dentro de uma
@@ -53,12 +269,93 @@ class Tracer
     /// A chave é o PID/TID. Isso é necessário para registrar corretamente o resultado do `execve`,
     /// que reporta sucesso na parada de *saída* da chamada de sistema.
     std::map<pid_t, bool> m_just_execed;
+
+    /// @brief A chamada de sistema em andamento de cada thread, preenchida na parada de entrada e
+    /// completada na parada de saída.
+    std::map<pid_t, SyscallEvent> m_current_syscall;
+
+    /// @brief O PID (tgid) do processo de cada thread rastreada.
+    std::map<pid_t, pid_t> m_tgid;
+
+    /// @brief Os consumidores de eventos ativos, criados a partir das opções ou registrados com
+    /// add_sink().
+    std::vector<std::unique_ptr<TraceSink>> m_sinks;
+
+    /// @brief Os consumidores que pediram a syscall em andamento de cada thread, uma entrada por
+    /// índice em m_sinks. O vetor de cada thread é reaproveitado de uma syscall para outra.
+    std::map<pid_t, std::vector<bool>> m_wanted_by;
+
+    /// @brief A captura de payloads, se ativada nas opções.
+    std::unique_ptr<PayloadCapture> m_payload;
+
+    /// @brief Syscalls rastreadas, indexadas pelo número. Vazio rastreia todas.
+    std::vector<bool> m_syscall_filter;
+
+    /// @brief Marca as threads cuja syscall em andamento foi excluída pelo filtro.
+    std::map<pid_t, bool> m_skip_syscall;
+
+    /// @brief O canal de controle, se ativado nas opções.
+    std::unique_ptr<ControlChannel> m_control;
+
+    /// @brief O governador de overhead, se ativado nas opções.
+    std::unique_ptr<OverheadGovernor> m_governor;
+
+    /// @brief signalfd do SIGCHLD, usado para aguardar paradas junto com o canal de controle ou
+    /// com o prazo do governador.
+    int m_signal_fd = -1;
+
+    /// @brief Verdadeiro enquanto o rastreamento de syscalls está pausado.
+    bool m_paused = false;
+
+    /// @brief Threads que aguardam o SIGSTOP enviado pelo Tracer, e o que fazer com elas.
+    std::map<pid_t, PendingStop> m_pending_stop;
+
+    /// @brief Filhos novos cujo SIGSTOP inicial chegou antes do evento de fork do pai. Ficam
+    /// parados até o evento, para que nenhuma syscall deles passe sem ser vista.
+    std::set<pid_t> m_early_children;
+
+    /// @brief Filhos novos já registrados cujo SIGSTOP inicial ainda não chegou.
+    std::set<pid_t> m_new_children;
+
+    /// @brief O filtro de eventos, se ativado nas opções.
+    std::shared_ptr<const FilterProgram> m_filter;
+
+    /// @brief Marca as threads cuja syscall em andamento só pode ser filtrada na saída (o filtro
+    /// depende de ret ou dur). A entrada é formatada, mas só registrada se o filtro passar.
+    std::map<pid_t, bool> m_filter_at_exit;
+
+    /// @brief Threads que o filtro exclui só pelo pid/tid. Elas rodam com PTRACE_CONT, sem
+    /// nenhuma parada de syscall.
+    std::set<pid_t> m_excluded_threads;
 };
 
+/**
+ * @brief Encontra todos os processos e threads descendentes de um determinado PID raiz.
+ * @param root_pid O ID do processo a partir do qual a busca deve ser iniciada.
+ * @return Um vetor contendo todos os PIDs e TIDs relacionados.
+ */
+std::vector<pid_t> find_all_related(pid_t root_pid);
+
+/**
+ * @brief Anexa um processo e todos os seus descendentes, deixando as threads paradas para o
+ * Tracer.
+ * @param root_pid O PID raiz.
+ * @return As threads anexadas, para o construtor do Tracer. Vazio se nenhuma foi anexada.
+ */
+std::vector<pid_t> attach_tree(pid_t root_pid);
+
+/**
+ * @brief Cria um processo com fork para executar um programa sob o ptrace.
+ * @param args O comando e os argumentos para o programa a ser executado.
+ * @return O PID do filho, parado antes do execvp, para o construtor do Tracer.
+ */
+pid_t spawn_traced(const std::vector<std::string> &args);
+
 /**
  * @brief Cria um novo processo com fork e o rastreia.
  * @param args O comando e os argumentos para o programa a ser executado.
+ * @param options As opções repassadas ao Tracer.
  * Esta função lida com o código padrão (boilerplate) de criar um fork, configurar o ptrace no
  * processo filho, e então iniciar uma instância do Tracer.
  */
-void fork_and_trace(const std::vector<std::string> &args);
\ No newline at end of file
+void fork_and_trace(const std::vector<std::string> &args, const TracerOptions &options = {});
\ No newline at end of file
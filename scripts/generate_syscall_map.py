@@ -142,6 +142,15 @@ def parse_syscall_signatures(kernel_path):
     return signatures
 
 
+# Assinaturas definidas apenas no código da arquitetura (ex: arch/x86/kernel/sys_x86_64.c), que
+# não aparecem no include/linux/syscalls.h.
+ARCH_SIGNATURES = {
+    "sys_mmap": {"arg_count": 6,
+                 "arg_types": ["unsigned long", "unsigned long", "unsigned long", "unsigned long",
+                               "unsigned long", "unsigned long"]},
+}
+
+
 def generate_cpp_file(final_syscall_data):
     """Gera um arquivo C++ que define um mapa de informações de chamadas de sistema.
 
@@ -177,7 +186,7 @@ if __name__ == "__main__":
     for name, table_data in syscall_table.items():
         num = table_data['number']
         entry_point = table_data['entry_point']
-        sig_data = signatures.get(entry_point)
+        sig_data = signatures.get(entry_point) or ARCH_SIGNATURES.get(entry_point)
         if sig_data:
             final_data[num] = {"name": name, "arg_count": sig_data['arg_count'], "arg_types": sig_data['arg_types']}
         else:
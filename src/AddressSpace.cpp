@@ -0,0 +1,347 @@
+#include "AddressSpace.h" // Headers do projeto
+#include "Syscall.h"      // Headers do projeto
+
+#include "spdlog/spdlog.h" // Usado para registrar o relatório
+
+#include <algorithm> // Usado pelo std::max e pela ordenação dos locais
+#include <iterator>  // Usado pelo std::prev
+#include <sstream>   // Usado para separar os campos do /proc/[pid]/maps
+
+#include <sys/mman.h> // Usado pelo MAP_ANONYMOUS e MADV_DONTNEED
+#include <unistd.h>   // Usado pelo sysconf do tamanho da página
+
+/// @brief Intervalo mínimo entre duas amostras de um mesmo processo na série temporal.
+static constexpr std::uint64_t kSampleIntervalNs = 100000000ULL;
+/// @brief Locais de chamada listados no relatório.
+static constexpr std::size_t kTopSites = 10;
+
+AddressSpaceProfiler::AddressSpaceProfiler(const std::string &path)
+    : m_page_mask(~static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE) - 1)),
+      m_file(path, std::ios::trunc)
+{
+    if (!m_file)
+    {
+        spdlog::error("Não foi possível abrir o arquivo de perfil de memória {}", path);
+    }
+    else
+    {
+        m_file << "time_ms,pid,anonymous_bytes,file_bytes,dontneed_bytes\n";
+        spdlog::info("Gravando o perfil de memória em {}", path);
+    }
+
+    static const std::pair<const char *, Kind> kTable[] = {
+        {"mmap", Kind::Mmap},
+        {"munmap", Kind::Munmap},
+        {"mremap", Kind::Mremap},
+        {"brk", Kind::Brk},
+        {"madvise", Kind::Madvise},
+    };
+    m_kind_by_nr = Syscall::table_by_number(kTable, Kind::None);
+}
+
+CaptureLevel AddressSpaceProfiler::on_syscall_entry(const SyscallEvent &event)
+{
+    if (event.nr < 0 || static_cast<std::size_t>(event.nr) >= m_kind_by_nr.size() ||
+        m_kind_by_nr[event.nr] == Kind::None)
+        return CaptureLevel::Skip;
+    return CaptureLevel::Event;
+}
+
+void AddressSpaceProfiler::on_syscall_exit(const SyscallEvent &event)
+{
+    if (event.nr < 0 || static_cast<std::size_t>(event.nr) >= m_kind_by_nr.size() ||
+        m_kind_by_nr[event.nr] == Kind::None)
+        return;
+    if (m_origin_ns == 0)
+        m_origin_ns = event.entry_ns;
+    m_last_ns = event.exit_ns;
+    if (event.ret < 0 && event.ret >= -4095) // Faixa de errno do kernel.
+        return;
+
+    auto page_up = [this](std::uint64_t value) { return (value + ~m_page_mask) & m_page_mask; };
+    ProcessState &state = process(event.pid);
+    std::uint64_t ret = static_cast<std::uint64_t>(event.ret);
+
+    switch (m_kind_by_nr[event.nr])
+    {
+    case Kind::Mmap:
+        map(state, ret, ret + page_up(event.args[1]), event.args[3] & MAP_ANONYMOUS,
+            site_of(state, event), true);
+        break;
+
+    case Kind::Munmap:
+        unmap(state, event.args[0], event.args[0] + page_up(event.args[1]), true);
+        break;
+
+    case Kind::Mremap:
+    {
+        // O intervalo movido mantém o tipo e o local que o criou; só a diferença de tamanho é
+        // contada como crescimento ou liberação.
+        std::uint64_t old_start = event.args[0];
+        std::uint64_t old_len = page_up(event.args[1]);
+        std::uint64_t new_len = page_up(event.args[2]);
+        const Region *found = find(state, old_start);
+        if (!found)
+            found = find(state, ret); // Semeado do /proc já depois de movido.
+        Region moved = found ? *found : Region{0, true, site_of(state, event)};
+        unmap(state, old_start, old_start + old_len, false);
+        map(state, ret, ret + new_len, moved.anonymous, moved.site, false);
+        if (moved.site >= 0 && new_len > old_len)
+            m_sites[moved.site].grown += new_len - old_len;
+        else if (moved.site >= 0)
+            m_sites[moved.site].released += old_len - new_len;
+        break;
+    }
+
+    case Kind::Brk:
+    {
+        std::uint64_t new_brk = page_up(ret);
+        if (state.brk != 0 && new_brk > state.brk)
+            map(state, state.brk, new_brk, true, site_of(state, event), true);
+        else if (state.brk != 0 && new_brk < state.brk)
+            unmap(state, new_brk, state.brk, true);
+        state.brk = new_brk;
+        break;
+    }
+
+    case Kind::Madvise:
+        if (static_cast<int>(event.args[2]) != MADV_DONTNEED)
+            return;
+        state.dontneed += page_up(event.args[1]);
+        state.dirty = true;
+        break;
+
+    default:
+        break;
+    }
+    sample(event.pid, state, event.exit_ns, false);
+}
+
+void AddressSpaceProfiler::on_process_event(const ProcessEvent &event)
+{
+    if (m_origin_ns == 0)
+        m_origin_ns = event.ts_ns;
+    m_last_ns = std::max(m_last_ns, event.ts_ns);
+
+    switch (event.type)
+    {
+    case ProcessEventType::Fork:
+    case ProcessEventType::Vfork:
+    case ProcessEventType::Clone:
+    {
+        // Um processo novo começa com uma cópia dos mapeamentos do pai, que não contam como
+        // crescimento de nenhum local.
+        auto parent = m_processes.find(event.pid);
+        if (event.child_pid == event.pid || parent == m_processes.end())
+            break;
+        ProcessState child = parent->second;
+        for (auto &[start, region] : child.regions)
+            region.site = -1;
+        child.last_sample_ns = 0;
+        child.dirty = true;
+        m_processes[event.child_pid] = std::move(child);
+        break;
+    }
+    case ProcessEventType::Exec:
+    {
+        // O novo programa substitui todo o espaço de endereçamento.
+        m_maps.forget(event.pid);
+        ProcessState &state = m_processes[event.pid];
+        state = ProcessState();
+        load(event.pid, state);
+        sample(event.pid, state, event.ts_ns, true);
+        break;
+    }
+    case ProcessEventType::Exit:
+    {
+        auto it = m_processes.find(event.pid);
+        if (event.tid != event.pid || it == m_processes.end())
+            break;
+        sample(event.pid, it->second, event.ts_ns, true);
+        report(event.pid, it->second);
+        m_processes.erase(it);
+        m_maps.forget(event.pid);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void AddressSpaceProfiler::on_finish()
+{
+    for (auto &[pid, state] : m_processes)
+    {
+        sample(pid, state, m_last_ns, true);
+        report(pid, state);
+    }
+    if (m_file)
+        m_file.flush();
+
+    // Os locais com mais memória ainda mapeada vêm primeiro; o nome desempata.
+    std::vector<const Site *> sites;
+    for (const Site &site : m_sites)
+    {
+        if (site.grown > 0)
+            sites.push_back(&site);
+    }
+    auto net = [](const Site *site) {
+        return static_cast<long long>(site->grown) - static_cast<long long>(site->released);
+    };
+    std::sort(sites.begin(), sites.end(), [&net](const Site *a, const Site *b) {
+        if (net(a) != net(b))
+            return net(a) > net(b);
+        if (a->grown != b->grown)
+            return a->grown > b->grown;
+        return a->name < b->name;
+    });
+    if (sites.size() > kTopSites)
+        sites.resize(kTopSites);
+    for (const Site *site : sites)
+    {
+        spdlog::info("MEMORY_SITE {}: +{} KiB, -{} KiB, líquido {} KiB em {} chamada(s)",
+                     site->name, site->grown / 1024, site->released / 1024, net(site) / 1024,
+                     site->calls);
+    }
+}
+
+AddressSpaceProfiler::ProcessState &AddressSpaceProfiler::process(pid_t pid)
+{
+    auto it = m_processes.find(pid);
+    if (it != m_processes.end())
+        return it->second;
+    // Ao anexar a um processo em execução, o que já estava mapeado vem do /proc.
+    ProcessState &state = m_processes[pid];
+    load(pid, state);
+    return state;
+}
+
+void AddressSpaceProfiler::load(pid_t pid, ProcessState &state)
+{
+    std::ifstream file("/proc/" + std::to_string(pid) + "/maps");
+    std::string line;
+    while (std::getline(file, line))
+    {
+        // Formato: "início-fim permissões deslocamento dispositivo inode caminho".
+        std::istringstream fields(line);
+        std::string range, perms, offset, dev, inode, path;
+        fields >> range >> perms >> offset >> dev >> inode;
+        std::getline(fields >> std::ws, path);
+
+        Region region;
+        region.anonymous = path.empty() || path == "[heap]" || path.compare(0, 6, "[stack") == 0 ||
+                           path.compare(0, 6, "[anon:") == 0;
+        if (!region.anonymous && path.front() != '/')
+            continue; // [vdso], [vvar], [vsyscall], etc.
+
+        std::uint64_t start = std::stoull(range.substr(0, range.find('-')), nullptr, 16);
+        region.end = std::stoull(range.substr(range.find('-') + 1), nullptr, 16);
+        if (path == "[heap]")
+            state.brk = region.end;
+        state.regions.emplace(start, region);
+        (region.anonymous ? state.anonymous : state.file) += region.end - start;
+    }
+    state.peak = std::max(state.peak, state.anonymous + state.file);
+    state.dirty = true;
+}
+
+const AddressSpaceProfiler::Region *AddressSpaceProfiler::find(const ProcessState &state,
+                                                               std::uint64_t addr)
+{
+    auto it = state.regions.upper_bound(addr);
+    if (it == state.regions.begin())
+        return nullptr;
+    --it;
+    return addr < it->second.end ? &it->second : nullptr;
+}
+
+int AddressSpaceProfiler::site_of(ProcessState &state, const SyscallEvent &event)
+{
+    auto key = std::make_pair(event.nr, event.ip);
+    auto it = state.sites.find(key);
+    if (it == state.sites.end())
+    {
+        const Syscall::SyscallInfo *info = Syscall::get_syscall_info(event.nr);
+        std::string name = (info ? info->name : std::to_string(event.nr)) + " " +
+                           m_maps.resolve(event.pid, event.ip);
+        auto [index, inserted] = m_site_index.emplace(name, static_cast<int>(m_sites.size()));
+        if (inserted)
+        {
+            m_sites.push_back(Site{name});
+        }
+        it = state.sites.emplace(key, index->second).first;
+    }
+    ++m_sites[it->second].calls;
+    return it->second;
+}
+
+void AddressSpaceProfiler::unmap(ProcessState &state, std::uint64_t start, std::uint64_t end,
+                                 bool account)
+{
+    if (start >= end)
+        return;
+    // Começa pelo intervalo que contém o início, se houver um.
+    auto it = state.regions.upper_bound(start);
+    if (it != state.regions.begin() && std::prev(it)->second.end > start)
+        --it;
+    while (it != state.regions.end() && it->first < end)
+    {
+        std::uint64_t region_start = it->first;
+        Region region = it->second;
+        it = state.regions.erase(it);
+
+        // As sobras dos dois lados continuam mapeadas com o mesmo tipo e local.
+        if (region_start < start)
+            state.regions.emplace(region_start, Region{start, region.anonymous, region.site});
+        if (region.end > end)
+            state.regions.emplace(end, Region{region.end, region.anonymous, region.site});
+
+        std::uint64_t bytes = std::min(region.end, end) - std::max(region_start, start);
+        (region.anonymous ? state.anonymous : state.file) -= bytes;
+        if (account && region.site >= 0)
+            m_sites[region.site].released += bytes;
+    }
+    state.dirty = true;
+}
+
+void AddressSpaceProfiler::map(ProcessState &state, std::uint64_t start, std::uint64_t end,
+                               bool anonymous, int site, bool account)
+{
+    if (start >= end)
+        return;
+    // Um mapeamento novo substitui o que estava no intervalo (MAP_FIXED, MREMAP_FIXED).
+    unmap(state, start, end, true);
+
+    // Crescimentos contíguos do mesmo local (como os do brk) estendem o intervalo anterior.
+    auto it = state.regions.lower_bound(start);
+    if (it != state.regions.begin() && std::prev(it)->second.end == start &&
+        std::prev(it)->second.anonymous == anonymous && std::prev(it)->second.site == site)
+        std::prev(it)->second.end = end;
+    else
+        state.regions.emplace(start, Region{end, anonymous, site});
+
+    (anonymous ? state.anonymous : state.file) += end - start;
+    state.peak = std::max(state.peak, state.anonymous + state.file);
+    if (account && site >= 0)
+        m_sites[site].grown += end - start;
+}
+
+void AddressSpaceProfiler::sample(pid_t pid, ProcessState &state, std::uint64_t now_ns, bool force)
+{
+    if (!m_file || !state.dirty)
+        return;
+    if (!force && state.last_sample_ns != 0 && now_ns - state.last_sample_ns < kSampleIntervalNs)
+        return;
+    std::uint64_t elapsed = now_ns > m_origin_ns ? now_ns - m_origin_ns : 0;
+    m_file << elapsed / 1000000 << ',' << pid << ',' << state.anonymous << ',' << state.file << ','
+           << state.dontneed << '\n';
+    state.last_sample_ns = now_ns;
+    state.dirty = false;
+}
+
+void AddressSpaceProfiler::report(pid_t pid, const ProcessState &state) const
+{
+    spdlog::info(
+        "MEMORY [PID:{}] anônima {} KiB, arquivo {} KiB, pico {} KiB, MADV_DONTNEED {} KiB", pid,
+        state.anonymous / 1024, state.file / 1024, state.peak / 1024, state.dontneed / 1024);
+}
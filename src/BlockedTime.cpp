@@ -0,0 +1,193 @@
+#include "BlockedTime.h" // Headers do projeto
+#include "Syscall.h"     // Headers do projeto
+
+#include "spdlog/spdlog.h" // Usado para registrar o relatório
+
+#include <algorithm> // Usado pelas operações de heap e ordenação
+#include <utility>   // Usado pelo std::pair na tabela de classificação
+
+/// @brief Tamanho de cada intervalo da linha do tempo por thread (um segundo).
+static constexpr std::uint64_t kTimelineBucketNs = 1000000000ULL;
+
+/// @brief Nomes curtos de cada classe, na mesma ordem de BlockClass.
+static const char *const kClassNames[] = {"io", "futex", "poll", "sleep", "net"};
+
+/**
+ * @brief Formata uma duração em nanossegundos como milissegundos ou segundos.
+ * @param ns A duração em nanossegundos.
+ * @return A duração formatada (ex: "12.345ms", "3.200s").
+ */
+static std::string format_duration(std::uint64_t ns)
+{
+    if (ns >= kTimelineBucketNs)
+        return fmt::format("{:.3f}s", ns / 1e9);
+    return fmt::format("{:.3f}ms", ns / 1e6);
+}
+
+/**
+ * @brief Formata os tempos de todas as classes em uma única linha.
+ * @param times Os nanossegundos bloqueados em cada classe.
+ */
+template <typename Times> static std::string format_classes(const Times &times)
+{
+    std::string out;
+    for (std::size_t i = 0; i < times.size(); ++i)
+    {
+        if (i > 0)
+            out += ' ';
+        out += fmt::format("{}={}", kClassNames[i], format_duration(times[i]));
+    }
+    return out;
+}
+
+BlockedTimeProfiler::BlockedTimeProfiler(std::size_t top_n) : m_top_n(top_n)
+{
+    // Tabela de nomes de syscalls que costumam bloquear, agrupadas por classe. Os nomes são
+    // convertidos para números uma única vez, assim o caminho quente só faz um acesso ao vetor.
+    static const std::pair<const char *, BlockClass> kTable[] = {
+        {"read", BlockClass::Io},
+        {"write", BlockClass::Io},
+        {"pread64", BlockClass::Io},
+        {"pwrite64", BlockClass::Io},
+        {"readv", BlockClass::Io},
+        {"writev", BlockClass::Io},
+        {"preadv", BlockClass::Io},
+        {"pwritev", BlockClass::Io},
+        {"preadv2", BlockClass::Io},
+        {"pwritev2", BlockClass::Io},
+        {"fsync", BlockClass::Io},
+        {"fdatasync", BlockClass::Io},
+        {"sync_file_range", BlockClass::Io},
+        {"sendfile", BlockClass::Io},
+        {"splice", BlockClass::Io},
+        {"copy_file_range", BlockClass::Io},
+        {"io_getevents", BlockClass::Io},
+        {"io_pgetevents", BlockClass::Io},
+        {"io_uring_enter", BlockClass::Io},
+        {"futex", BlockClass::Futex},
+        {"futex_waitv", BlockClass::Futex},
+        {"futex_wait", BlockClass::Futex},
+        {"poll", BlockClass::Poll},
+        {"ppoll", BlockClass::Poll},
+        {"select", BlockClass::Poll},
+        {"pselect6", BlockClass::Poll},
+        {"epoll_wait", BlockClass::Poll},
+        {"epoll_pwait", BlockClass::Poll},
+        {"epoll_pwait2", BlockClass::Poll},
+        {"nanosleep", BlockClass::Sleep},
+        {"clock_nanosleep", BlockClass::Sleep},
+        {"pause", BlockClass::Sleep},
+        {"rt_sigsuspend", BlockClass::Sleep},
+        {"rt_sigtimedwait", BlockClass::Sleep},
+        {"wait4", BlockClass::Sleep},
+        {"waitid", BlockClass::Sleep},
+        {"accept", BlockClass::Network},
+        {"accept4", BlockClass::Network},
+        {"connect", BlockClass::Network},
+        {"recvfrom", BlockClass::Network},
+        {"recvmsg", BlockClass::Network},
+        {"recvmmsg", BlockClass::Network},
+        {"sendto", BlockClass::Network},
+        {"sendmsg", BlockClass::Network},
+        {"sendmmsg", BlockClass::Network},
+    };
+
+    m_class_by_nr = Syscall::table_by_number(kTable, BlockClass::Count);
+}
+
+BlockClass BlockedTimeProfiler::classify(long nr) const
+{
+    if (nr < 0 || static_cast<std::size_t>(nr) >= m_class_by_nr.size())
+        return BlockClass::Count;
+    return m_class_by_nr[nr];
+}
+
+CaptureLevel BlockedTimeProfiler::on_syscall_entry(const SyscallEvent &event)
+{
+    // A origem não pode vir da primeira saída: uma chamada longa que entrou antes dela teria a
+    // entrada anterior à origem.
+    if (m_origin_ns == 0)
+        m_origin_ns = event.entry_ns;
+
+    // As demais syscalls só contam para o tempo de parede da thread.
+    if (classify(event.nr) == BlockClass::Count || m_top_n == 0)
+        return CaptureLevel::Event;
+    return CaptureLevel::Decoded;
+}
+
+void BlockedTimeProfiler::on_syscall_exit(const SyscallEvent &event)
+{
+    // O tempo de parede da thread conta todas as syscalls, mesmo as que não bloqueiam.
+    ThreadStats &stats = m_threads[event.tid];
+    if (stats.first_ns == 0)
+        stats.first_ns = event.entry_ns;
+    stats.last_ns = event.exit_ns;
+
+    BlockClass cls = classify(event.nr);
+    if (cls == BlockClass::Count || event.exit_ns < event.entry_ns)
+        return;
+
+    auto idx = static_cast<std::size_t>(cls);
+    std::uint64_t duration = event.exit_ns - event.entry_ns;
+    stats.blocked_ns[idx] += duration;
+    stats.calls[idx]++;
+
+    // Distribui o intervalo bloqueado entre os intervalos de um segundo que ele atravessa.
+    std::uint64_t start = event.entry_ns - m_origin_ns;
+    std::uint64_t end = event.exit_ns - m_origin_ns;
+    while (start < end)
+    {
+        std::uint64_t bucket = start / kTimelineBucketNs;
+        std::uint64_t bucket_end = (bucket + 1) * kTimelineBucketNs;
+        std::uint64_t slice_end = std::min(end, bucket_end);
+        stats.timeline[bucket][idx] += slice_end - start;
+        start = slice_end;
+    }
+
+    // Mantém apenas as N chamadas mais longas em um heap de mínimo.
+    if (m_top_n == 0)
+        return;
+    if (m_top.size() == m_top_n && duration <= m_top.front().duration_ns)
+        return;
+    BlockingCall call{duration, event.entry_ns, event.tid, event.nr, event.ret, event.args_str};
+    if (m_top.size() == m_top_n)
+    {
+        std::pop_heap(m_top.begin(), m_top.end(), std::greater<>());
+        m_top.back() = std::move(call);
+    }
+    else
+    {
+        m_top.push_back(std::move(call));
+    }
+    std::push_heap(m_top.begin(), m_top.end(), std::greater<>());
+}
+
+void BlockedTimeProfiler::on_finish()
+{
+    spdlog::info("BLOCKED_REPORT {} thread(s)", m_threads.size());
+    for (const auto &[tid, stats] : m_threads)
+    {
+        std::uint64_t wall = stats.last_ns - stats.first_ns;
+        std::uint64_t blocked = 0;
+        for (std::uint64_t ns : stats.blocked_ns)
+            blocked += ns;
+        double pct = wall ? 100.0 * blocked / wall : 0.0;
+        spdlog::info("BLOCKED_REPORT [TID:{}] wall={} blocked={} ({:.1f}%) {}", tid,
+                     format_duration(wall), format_duration(blocked), pct,
+                     format_classes(stats.blocked_ns));
+
+        // A linha do tempo pode ser longa, então vai apenas para o arquivo de log.
+        for (const auto &[bucket, times] : stats.timeline)
+            spdlog::debug("BLOCKED_TIMELINE [TID:{}] +{}s {}", tid, bucket, format_classes(times));
+    }
+
+    std::sort_heap(m_top.begin(), m_top.end(), std::greater<>());
+    for (std::size_t i = 0; i < m_top.size(); ++i)
+    {
+        const BlockingCall &call = m_top[i];
+        const auto info = Syscall::get_syscall_info(call.nr);
+        spdlog::info("BLOCKED_TOP #{} [TID:{}] +{:.3f}s {}({}) = {} took {}", i + 1, call.tid,
+                     (call.entry_ns - m_origin_ns) / 1e9, info ? info->name : "syscall", call.args,
+                     call.ret, format_duration(call.duration_ns));
+    }
+}
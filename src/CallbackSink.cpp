@@ -0,0 +1,44 @@
+#include "CallbackSink.h" // Headers do projeto
+
+#include <utility> // Usado pelo std::move das funções
+
+CallbackSink::CallbackSink(EntryCallback entry, ExitCallback exit, ProcessCallback process,
+                           FinishCallback finish)
+    : m_entry(std::move(entry)), m_exit(std::move(exit)), m_process(std::move(process)),
+      m_finish(std::move(finish))
+{
+}
+
+CaptureLevel CallbackSink::on_syscall_entry(const SyscallEvent &event)
+{
+    if (m_entry)
+    {
+        return m_entry(event);
+    }
+    // Sem decisão na entrada, basta o evento tipado para quem só olha as saídas.
+    return m_exit ? CaptureLevel::Event : CaptureLevel::Skip;
+}
+
+void CallbackSink::on_syscall_exit(const SyscallEvent &event)
+{
+    if (m_exit)
+    {
+        m_exit(event);
+    }
+}
+
+void CallbackSink::on_process_event(const ProcessEvent &event)
+{
+    if (m_process)
+    {
+        m_process(event);
+    }
+}
+
+void CallbackSink::on_finish()
+{
+    if (m_finish)
+    {
+        m_finish();
+    }
+}
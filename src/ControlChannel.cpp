@@ -0,0 +1,148 @@
+#include "ControlChannel.h" // Headers do projeto
+
+#include "spdlog/spdlog.h" // Usado para registrar os comandos recebidos
+
+#include <cerrno>  // Usado pelo errno das chamadas de socket
+#include <cstring> // Usado pelo strerror e strncpy
+#include <sstream> // Usado para separar o comando dos argumentos
+
+#include <sys/socket.h> // Usado pelas chamadas de socket
+#include <sys/un.h>     // Usado pela struct sockaddr_un
+#include <unistd.h>     // Usado pelo close, read e unlink
+
+/// @brief Conexões com comandos incompletos guardadas ao mesmo tempo; as mais antigas são
+/// descartadas quando o limite é atingido.
+static constexpr std::size_t kMaxClients = 16;
+
+/// @brief Tamanho máximo de uma linha de comando.
+static constexpr std::size_t kMaxLineBytes = 4096;
+
+ControlChannel::ControlChannel(const std::string &path) : m_path(path)
+{
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path))
+    {
+        spdlog::error("Caminho do socket de controle muito longo: {}", path);
+        return;
+    }
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(path.c_str()); // Remove um socket antigo deixado por uma execução anterior.
+
+    m_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (m_fd < 0 || bind(m_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+        listen(m_fd, 4) < 0)
+    {
+        spdlog::error("Não foi possível abrir o socket de controle {}: {}", path, strerror(errno));
+        if (m_fd >= 0)
+            close(m_fd);
+        m_fd = -1;
+        return;
+    }
+    spdlog::info("Canal de controle em {}", path);
+}
+
+ControlChannel::~ControlChannel()
+{
+    for (const Client &client : m_clients)
+        close(client.fd);
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+        unlink(m_path.c_str());
+    }
+}
+
+void ControlChannel::poll_fds(std::vector<pollfd> &fds) const
+{
+    fds.push_back({m_fd, POLLIN, 0});
+    for (const Client &client : m_clients)
+        fds.push_back({client.fd, POLLIN, 0});
+}
+
+bool ControlChannel::receive(ControlCommand &command)
+{
+    // As conexões novas também são lidas sem bloquear, como as antigas.
+    int fd;
+    while ((fd = accept4(m_fd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK)) >= 0)
+    {
+        if (m_clients.size() == kMaxClients)
+        {
+            close(m_clients.front().fd);
+            m_clients.erase(m_clients.begin());
+        }
+        m_clients.push_back({fd, {}});
+    }
+
+    // Lê o que cada conexão já enviou. Uma linha termina no '\n', no limite de tamanho ou
+    // quando o cliente fecha a escrita.
+    char buf[256];
+    for (auto it = m_clients.begin(); it != m_clients.end();)
+    {
+        bool done = false;
+        while (!done)
+        {
+            ssize_t got = read(it->fd, buf, sizeof(buf));
+            if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+            if (got < 0 && errno == EINTR)
+                continue;
+            if (got > 0)
+                it->line.append(buf, got);
+            done = got <= 0 || it->line.find('\n') != std::string::npos ||
+                   it->line.size() >= kMaxLineBytes;
+        }
+        if (!done)
+        {
+            ++it;
+            continue;
+        }
+
+        command = ControlCommand{};
+        command.client = it->fd;
+        std::string line = std::move(it->line);
+        it = m_clients.erase(it);
+        if (parse(std::move(line), command))
+            return true;
+    }
+    return false;
+}
+
+bool ControlChannel::parse(std::string line, ControlCommand &command)
+{
+    line = line.substr(0, line.find('\n'));
+    if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+
+    std::istringstream words(line);
+    std::string verb;
+    words >> verb;
+    spdlog::info("CONTROL {}", line);
+
+    if (verb == "pause")
+        command.type = ControlCommand::Type::Pause;
+    else if (verb == "resume")
+        command.type = ControlCommand::Type::Resume;
+    else if (verb == "detach")
+        command.type = ControlCommand::Type::Detach;
+    else if (verb == "filter" && words >> command.argument)
+        command.type = ControlCommand::Type::Filter;
+    else if ((verb == "add" || verb == "remove") && words >> command.pid && command.pid > 0)
+        command.type = verb == "add" ? ControlCommand::Type::Add : ControlCommand::Type::Remove;
+    else
+    {
+        reply(command, "unknown command (pause | resume | filter <syscalls>|all | add <pid> | "
+                       "remove <pid> | detach)");
+        return false;
+    }
+    return true;
+}
+
+void ControlChannel::reply(const ControlCommand &command, const std::string &error)
+{
+    if (command.client < 0)
+        return;
+    std::string message = error.empty() ? "ok\n" : "error: " + error + "\n";
+    (void)!send(command.client, message.data(), message.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+    close(command.client);
+}
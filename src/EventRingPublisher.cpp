@@ -0,0 +1,169 @@
+#include "EventRingPublisher.h" // Headers do projeto
+
+#include "spdlog/spdlog.h" // Usado para registrar erros ao criar o anel
+
+#include <cerrno>  // Usado pelo EEXIST de um anel já existente
+#include <climits> // Usado pelo INT_MAX do wake
+#include <cstring> // Usado pelo memcpy do identificador e pelo strerror
+#include <new>     // Usado pelo placement new do cabeçalho e dos slots
+
+bool EventRingPublisher::parse_spec(const std::string &spec, std::string &name,
+                                    std::uint32_t &slots, std::string &error)
+{
+    const auto colon = spec.rfind(':');
+    name = "/" + spec.substr(0, colon);
+    slots = kDefaultSlots;
+    if (colon != std::string::npos)
+    {
+        try
+        {
+            unsigned long value = std::stoul(spec.substr(colon + 1));
+            slots = static_cast<std::uint32_t>(value);
+            if (value != slots)
+                slots = 0;
+        }
+        catch (const std::exception &)
+        {
+            slots = 0;
+        }
+    }
+    // O shm_open aceita um único componente, sem barras além da inicial.
+    if (name.size() < 2 || name.find('/', 1) != std::string::npos)
+    {
+        error = "invalid ring name '" + spec.substr(0, colon) + "'";
+        return false;
+    }
+    if (slots < 2 || (slots & (slots - 1)) != 0)
+    {
+        error = "slots must be a power of two, got '" + spec.substr(colon + 1) + "'";
+        return false;
+    }
+    return true;
+}
+
+EventRingPublisher::EventRingPublisher(const std::string &name, std::uint32_t slots)
+    : m_name(name), m_mask(slots - 1)
+{
+    // O anel nunca é reaproveitado: truncar um anel existente corromperia os leitores de outro
+    // TracerC que ainda o têm mapeado.
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 && errno == EEXIST)
+    {
+        spdlog::error("O anel de eventos /dev/shm{} já existe (em uso por outro TracerC, ou "
+                      "deixado por uma execução interrompida); escolha outro nome ou remova-o",
+                      name);
+        return;
+    }
+    m_size = sizeof(EventRingHeader) + std::size_t{slots} * sizeof(EventRingSlot);
+    void *base = MAP_FAILED;
+    if (fd >= 0 && ftruncate(fd, static_cast<off_t>(m_size)) == 0)
+        base = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED)
+    {
+        spdlog::error("Não foi possível criar o anel de eventos {}: {}", name,
+                      std::strerror(errno));
+        if (fd >= 0)
+        {
+            close(fd);
+            shm_unlink(name.c_str());
+        }
+        return;
+    }
+    close(fd);
+
+    // O ftruncate já zerou o objeto; os campos fixos são escritos antes do identificador, para
+    // que um leitor que reconheça o identificador veja o cabeçalho completo.
+    m_header = new (base) EventRingHeader();
+    m_slots = new (static_cast<char *>(base) + sizeof(EventRingHeader)) EventRingSlot[slots]();
+    m_header->version = EventRingFormat::kVersion;
+    m_header->header_size = sizeof(EventRingHeader);
+    m_header->slot_size = sizeof(EventRingSlot);
+    m_header->capacity = slots;
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(m_header->magic, EventRingFormat::kMagic, sizeof(m_header->magic));
+    spdlog::info("Publicando eventos no anel /dev/shm{} ({} slots)", name, slots);
+}
+
+EventRingPublisher::~EventRingPublisher()
+{
+    if (!m_header)
+        return;
+    munmap(m_header, m_size);
+    shm_unlink(m_name.c_str());
+}
+
+void EventRingPublisher::on_syscall_exit(const SyscallEvent &event)
+{
+    EventRingEvent out{};
+    out.type = static_cast<std::uint32_t>(EventRingType::Syscall);
+    out.tid = event.tid;
+    out.pid = event.pid;
+    out.nr = static_cast<std::int32_t>(event.nr);
+    out.entry_ns = event.entry_ns;
+    out.exit_ns = event.exit_ns;
+    out.ret = event.ret;
+    out.ip = event.ip;
+    for (int i = 0; i < 6; ++i)
+        out.args[i] = event.args[i];
+    publish(out);
+}
+
+void EventRingPublisher::on_process_event(const ProcessEvent &event)
+{
+    // O término já é publicado pelo evento Exit, que vem logo depois.
+    if (event.type == ProcessEventType::Exiting)
+    {
+        return;
+    }
+    static const EventRingType kTypes[] = {EventRingType::Fork, EventRingType::Vfork,
+                                           EventRingType::Clone, EventRingType::Exec,
+                                           EventRingType::Exit};
+    EventRingEvent out{};
+    out.type = static_cast<std::uint32_t>(kTypes[static_cast<int>(event.type)]);
+    out.tid = event.tid;
+    out.pid = event.pid;
+    out.nr = -1;
+    out.child_tid = event.child_tid;
+    out.child_pid = event.child_pid;
+    out.status = event.status;
+    out.entry_ns = event.ts_ns;
+    out.exit_ns = event.ts_ns;
+    publish(out);
+}
+
+void EventRingPublisher::on_finish()
+{
+    if (!m_header)
+        return;
+    m_header->closed.store(1);
+    wake();
+    munmap(m_header, m_size);
+    shm_unlink(m_name.c_str());
+    m_header = nullptr;
+}
+
+void EventRingPublisher::publish(const EventRingEvent &event)
+{
+    if (!m_header)
+        return;
+    // Seqlock do slot: 0 enquanto escreve, n + 1 depois (ver EventRing.h).
+    EventRingSlot &slot = m_slots[m_next & m_mask];
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&slot.event, &event, sizeof(event));
+    slot.seq.store(m_next + 1, std::memory_order_release);
+    ++m_next;
+
+    // A escrita de write_seq e a leitura de waiters são sequencialmente consistentes, assim
+    // como o incremento de waiters e a releitura de write_seq no leitor: um dos dois sempre
+    // enxerga o outro, e nenhum wake se perde.
+    m_header->write_seq.store(m_next);
+    if (m_header->waiters.load() > 0)
+        wake();
+}
+
+void EventRingPublisher::wake()
+{
+    m_header->futex.fetch_add(1);
+    syscall(SYS_futex, &m_header->futex, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
@@ -0,0 +1,418 @@
+#include "FilterProgram.h" // Headers do projeto
+#include "Syscall.h"       // Headers do projeto
+
+#include <algorithm> // Usado pelo std::sort e std::binary_search dos conjuntos
+#include <cctype>    // Usado pela classificação de caracteres do analisador léxico
+#include <cerrno>    // Usado para detectar números fora da faixa
+#include <cstdlib>   // Usado pelo strtoll
+#include <regex>     // Usado pelo operador =~, resolvido na compilação
+
+/**
+ * @class FilterProgram::Parser
+ * @brief Analisador descendente recursivo que emite o bytecode diretamente.
+ */
+class FilterProgram::Parser
+{
+  public:
+    Parser(const std::string &text, FilterProgram &program) : m_text(text), m_program(program)
+    {
+    }
+
+    /// @brief Analisa o texto inteiro; retorna falso e preenche o erro em caso de falha.
+    bool parse(std::string &error)
+    {
+        skip_spaces();
+        if (!parse_or() || (m_pos < m_text.size() && fail("unexpected input")))
+        {
+            error = m_error + " at column " + std::to_string(m_error_pos + 1);
+            return false;
+        }
+        return true;
+    }
+
+  private:
+    bool fail(const std::string &message)
+    {
+        if (m_error.empty())
+        {
+            m_error = message;
+            m_error_pos = m_pos;
+        }
+        return false;
+    }
+
+    void skip_spaces()
+    {
+        while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos])))
+            ++m_pos;
+    }
+
+    /// @brief Consome o símbolo se ele estiver na posição atual.
+    bool accept(const char *symbol)
+    {
+        std::size_t len = std::char_traits<char>::length(symbol);
+        if (m_text.compare(m_pos, len, symbol) != 0)
+            return false;
+        m_pos += len;
+        skip_spaces();
+        return true;
+    }
+
+    /// @brief Lê um identificador (letras, dígitos e '_').
+    std::string identifier()
+    {
+        std::size_t start = m_pos;
+        while (m_pos < m_text.size() &&
+               (std::isalnum(static_cast<unsigned char>(m_text[m_pos])) || m_text[m_pos] == '_'))
+            ++m_pos;
+        std::string word = m_text.substr(start, m_pos - start);
+        skip_spaces();
+        return word;
+    }
+
+    /// @brief Emite uma instrução e acompanha a profundidade da pilha de avaliação.
+    bool emit(Instruction instruction)
+    {
+        if (instruction.op == OpCode::And || instruction.op == OpCode::Or)
+            --m_depth;
+        else if (instruction.op != OpCode::Not)
+            ++m_depth;
+        if (m_depth > kMaxStack)
+            return fail("expression too deep");
+        m_program.m_code.push_back(instruction);
+        return true;
+    }
+
+    bool parse_or()
+    {
+        if (!parse_and())
+            return false;
+        while (accept("||"))
+            if (!parse_and() || !emit({OpCode::Or, Field::Pid, 0, 0}))
+                return false;
+        return true;
+    }
+
+    bool parse_and()
+    {
+        if (!parse_unary())
+            return false;
+        while (accept("&&"))
+            if (!parse_unary() || !emit({OpCode::And, Field::Pid, 0, 0}))
+                return false;
+        return true;
+    }
+
+    bool parse_unary()
+    {
+        if (accept("!"))
+            return parse_unary() && emit({OpCode::Not, Field::Pid, 0, 0});
+        if (accept("("))
+            return parse_or() && (accept(")") || fail("expected ')'"));
+        return parse_compare();
+    }
+
+    bool parse_field(Field &field)
+    {
+        std::size_t start = m_pos;
+        std::string name = identifier();
+        if (name == "pid")
+            field = Field::Pid;
+        else if (name == "tid")
+            field = Field::Tid;
+        else if (name == "syscall")
+            field = Field::Syscall;
+        else if (name == "ret")
+            field = Field::Ret;
+        else if (name == "dur")
+            field = Field::Dur;
+        else if (name.size() == 4 && name.compare(0, 3, "arg") == 0 && name[3] >= '0' &&
+                 name[3] <= '5')
+            field = static_cast<Field>(static_cast<int>(Field::Arg0) + (name[3] - '0'));
+        else
+        {
+            m_pos = start;
+            return fail(name.empty() ? "expected a field" : "unknown field '" + name + "'");
+        }
+        return true;
+    }
+
+    /// @brief Lê um valor: um inteiro, ou o nome (com ou sem aspas) de uma syscall.
+    bool parse_value(Field field, long long &value)
+    {
+        std::size_t start = m_pos;
+        if (m_pos < m_text.size() && (std::isdigit(static_cast<unsigned char>(m_text[m_pos])) ||
+                                      m_text[m_pos] == '-'))
+        {
+            const char *begin = m_text.c_str() + m_pos;
+            char *end = nullptr;
+            errno = 0;
+            value = std::strtoll(begin, &end, 0);
+            if (end == begin || errno == ERANGE)
+                return fail("invalid number");
+            // Números de syscall indexam os conjuntos de 'in {}', então são limitados à tabela.
+            if (field == Field::Syscall &&
+                (value < 0 || Syscall::g_syscall_map.empty() ||
+                 value > Syscall::g_syscall_map.rbegin()->first))
+                return fail("unknown syscall " + std::to_string(value));
+            m_pos += end - begin;
+            skip_spaces();
+            return true;
+        }
+
+        std::string name;
+        if (!parse_string(name) && m_error.empty())
+            name = identifier();
+        if (!m_error.empty())
+            return false;
+        if (field != Field::Syscall)
+        {
+            m_pos = start;
+            return fail("expected a number");
+        }
+        value = Syscall::find_syscall_number(name);
+        if (value < 0)
+        {
+            m_pos = start;
+            return fail("unknown syscall '" + name + "'");
+        }
+        return true;
+    }
+
+    /// @brief Lê uma string entre aspas duplas; retorna falso se não houver uma.
+    bool parse_string(std::string &out)
+    {
+        if (m_pos >= m_text.size() || m_text[m_pos] != '"')
+            return false;
+        std::size_t end = m_text.find('"', m_pos + 1);
+        if (end == std::string::npos)
+            return fail("unterminated string");
+        out = m_text.substr(m_pos + 1, end - m_pos - 1);
+        m_pos = end + 1;
+        skip_spaces();
+        return true;
+    }
+
+    bool parse_compare()
+    {
+        Field field;
+        if (!parse_field(field))
+            return false;
+
+        if (accept("=~"))
+        {
+            std::size_t start = m_pos;
+            std::string pattern;
+            if (field != Field::Syscall)
+                return fail("=~ only applies to syscall");
+            if (!parse_string(pattern))
+                return fail("expected a quoted regular expression");
+            std::vector<bool> set;
+            try
+            {
+                // A expressão é aplicada uma única vez a cada nome conhecido.
+                std::regex regex(pattern, std::regex::extended | std::regex::nosubs);
+                for (const auto &[nr, info] : Syscall::g_syscall_map)
+                {
+                    if (std::regex_match(info.name, regex))
+                    {
+                        if (static_cast<std::size_t>(nr) >= set.size())
+                            set.resize(nr + 1, false);
+                        set[nr] = true;
+                    }
+                }
+            }
+            catch (const std::regex_error &)
+            {
+                m_pos = start;
+                return fail("invalid regular expression");
+            }
+            if (set.empty())
+            {
+                m_pos = start;
+                return fail("regular expression matches no syscall");
+            }
+            m_program.m_syscall_sets.push_back(std::move(set));
+            return emit({OpCode::InSyscall, field,
+                         static_cast<std::uint32_t>(m_program.m_syscall_sets.size() - 1), 0});
+        }
+
+        if (m_text.compare(m_pos, 2, "in") == 0 &&
+            (m_pos + 2 >= m_text.size() ||
+             !std::isalnum(static_cast<unsigned char>(m_text[m_pos + 2]))))
+        {
+            m_pos += 2;
+            skip_spaces();
+            if (!accept("{"))
+                return fail("expected '{'");
+            std::vector<long long> values;
+            do
+            {
+                long long value;
+                if (!parse_value(field, value))
+                    return false;
+                values.push_back(value);
+            } while (accept(","));
+            if (!accept("}"))
+                return fail("expected '}'");
+
+            if (field == Field::Syscall)
+            {
+                std::vector<bool> set;
+                for (long long nr : values)
+                {
+                    if (static_cast<std::size_t>(nr) >= set.size())
+                        set.resize(nr + 1, false);
+                    set[nr] = true;
+                }
+                m_program.m_syscall_sets.push_back(std::move(set));
+                return emit({OpCode::InSyscall, field,
+                             static_cast<std::uint32_t>(m_program.m_syscall_sets.size() - 1), 0});
+            }
+            std::sort(values.begin(), values.end());
+            m_program.m_sets.push_back(std::move(values));
+            return emit(
+                {OpCode::InSet, field, static_cast<std::uint32_t>(m_program.m_sets.size() - 1), 0});
+        }
+
+        // Os operadores de dois caracteres são testados antes dos de um.
+        static const std::pair<const char *, OpCode> kOperators[] = {
+            {"==", OpCode::Eq}, {"!=", OpCode::Ne}, {"<=", OpCode::Le},
+            {">=", OpCode::Ge}, {"<", OpCode::Lt},  {">", OpCode::Gt},
+        };
+        for (const auto &[symbol, op] : kOperators)
+        {
+            if (accept(symbol))
+            {
+                long long value;
+                return parse_value(field, value) && emit({op, field, 0, value});
+            }
+        }
+        return fail("expected a comparison operator");
+    }
+
+    const std::string &m_text;
+    FilterProgram &m_program;
+    std::size_t m_pos = 0;
+    std::size_t m_depth = 0;
+    std::string m_error;
+    std::size_t m_error_pos = 0;
+};
+
+std::unique_ptr<FilterProgram> FilterProgram::compile(const std::string &text, std::string &error)
+{
+    auto program = std::unique_ptr<FilterProgram>(new FilterProgram());
+    Parser parser(text, *program);
+    if (!parser.parse(error))
+        return nullptr;
+    return program;
+}
+
+FilterProgram::Result FilterProgram::evaluate(const SyscallEvent &event, Phase phase) const
+{
+    Result stack[kMaxStack];
+    std::size_t sp = 0;
+    for (const Instruction &ins : m_code)
+    {
+        switch (ins.op)
+        {
+        case OpCode::And:
+        {
+            Result b = stack[--sp];
+            Result &a = stack[sp - 1];
+            if (a == Result::False || b == Result::False)
+                a = Result::False;
+            else if (a == Result::Unknown || b == Result::Unknown)
+                a = Result::Unknown;
+            continue;
+        }
+        case OpCode::Or:
+        {
+            Result b = stack[--sp];
+            Result &a = stack[sp - 1];
+            if (a == Result::True || b == Result::True)
+                a = Result::True;
+            else if (a == Result::Unknown || b == Result::Unknown)
+                a = Result::Unknown;
+            continue;
+        }
+        case OpCode::Not:
+            if (stack[sp - 1] != Result::Unknown)
+                stack[sp - 1] = stack[sp - 1] == Result::True ? Result::False : Result::True;
+            continue;
+        default:
+            break;
+        }
+
+        // Comparações: o campo precisa ser conhecido na fase atual.
+        long long value = 0;
+        bool known = true;
+        switch (ins.field)
+        {
+        case Field::Pid:
+            value = event.pid;
+            break;
+        case Field::Tid:
+            value = event.tid;
+            break;
+        case Field::Syscall:
+            known = phase != Phase::Thread;
+            value = event.nr;
+            break;
+        case Field::Ret:
+            known = phase == Phase::Exit;
+            value = event.ret;
+            break;
+        case Field::Dur:
+            known = phase == Phase::Exit;
+            value = static_cast<long long>(event.exit_ns - event.entry_ns);
+            break;
+        default:
+            known = phase != Phase::Thread;
+            value = static_cast<long long>(
+                event.args[static_cast<int>(ins.field) - static_cast<int>(Field::Arg0)]);
+            break;
+        }
+        if (!known)
+        {
+            stack[sp++] = Result::Unknown;
+            continue;
+        }
+
+        bool match = false;
+        switch (ins.op)
+        {
+        case OpCode::Eq:
+            match = value == ins.value;
+            break;
+        case OpCode::Ne:
+            match = value != ins.value;
+            break;
+        case OpCode::Lt:
+            match = value < ins.value;
+            break;
+        case OpCode::Le:
+            match = value <= ins.value;
+            break;
+        case OpCode::Gt:
+            match = value > ins.value;
+            break;
+        case OpCode::Ge:
+            match = value >= ins.value;
+            break;
+        case OpCode::InSet:
+            match = std::binary_search(m_sets[ins.index].begin(), m_sets[ins.index].end(), value);
+            break;
+        case OpCode::InSyscall:
+        {
+            const std::vector<bool> &set = m_syscall_sets[ins.index];
+            match = value >= 0 && static_cast<std::size_t>(value) < set.size() && set[value];
+            break;
+        }
+        default:
+            break;
+        }
+        stack[sp++] = match ? Result::True : Result::False;
+    }
+    return stack[0];
+}
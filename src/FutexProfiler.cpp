@@ -0,0 +1,254 @@
+#include "FutexProfiler.h" // Headers do projeto
+#include "Syscall.h"       // Headers do projeto
+
+#include "spdlog/spdlog.h" // Usado para registrar o relatório
+
+#include <algorithm> // Usado pela ordenação dos endereços e das threads
+#include <cerrno>    // Usado pelo EAGAIN, ETIMEDOUT e EINTR
+
+#include <linux/futex.h> // Usado pelas operações FUTEX_*
+
+/**
+ * @brief Diz se o retorno é o de uma espera interrompida por um sinal: EINTR ou um dos códigos
+ * internos do kernel para uma syscall que será reiniciada (ERESTARTSYS, ERESTARTNOINTR,
+ * ERESTARTNOHAND e, nas esperas com tempo limite e PI, ERESTART_RESTARTBLOCK).
+ */
+static bool interrupted(long long ret)
+{
+    return ret == -EINTR || ret == -512 || ret == -513 || ret == -514 || ret == -516;
+}
+
+/// @brief Nome de cada operação, na ordem de FUTEX_WAIT (0) a FUTEX_LOCK_PI2 (13).
+static const char *const kOpNames[] = {
+    "WAIT",
+    "WAKE",
+    "FD",
+    "REQUEUE",
+    "CMP_REQUEUE",
+    "WAKE_OP",
+    "LOCK_PI",
+    "UNLOCK_PI",
+    "TRYLOCK_PI",
+    "WAIT_BITSET",
+    "WAKE_BITSET",
+    "WAIT_REQUEUE_PI",
+    "CMP_REQUEUE_PI",
+    "LOCK_PI2",
+};
+
+/**
+ * @brief Formata uma duração em milissegundos, ou em segundos se for longa.
+ * @param ns A duração em nanossegundos.
+ */
+static std::string format_duration(std::uint64_t ns)
+{
+    if (ns >= 1000000000ULL)
+        return fmt::format("{:.3f}s", ns / 1e9);
+    return fmt::format("{:.3f}ms", ns / 1e6);
+}
+
+FutexProfiler::FutexProfiler(std::size_t top_n) : m_top_n(top_n)
+{
+    static const std::pair<const char *, Kind> kTable[] = {
+        {"futex", Kind::Futex},
+        {"futex_wait", Kind::FutexWait},
+        {"futex_wake", Kind::FutexWake},
+    };
+    m_kind_by_nr = Syscall::table_by_number(kTable, Kind::None);
+}
+
+CaptureLevel FutexProfiler::on_syscall_entry(const SyscallEvent &event)
+{
+    if (event.nr < 0 || static_cast<std::size_t>(event.nr) >= m_kind_by_nr.size() ||
+        m_kind_by_nr[event.nr] == Kind::None)
+        return CaptureLevel::Skip;
+    return CaptureLevel::Event;
+}
+
+void FutexProfiler::on_syscall_exit(const SyscallEvent &event)
+{
+    if (event.nr < 0 || static_cast<std::size_t>(event.nr) >= m_kind_by_nr.size())
+        return;
+
+    unsigned op;
+    switch (m_kind_by_nr[event.nr])
+    {
+    case Kind::Futex:
+        op = static_cast<unsigned>(event.args[1]) & FUTEX_CMD_MASK;
+        break;
+    case Kind::FutexWait:
+        op = FUTEX_WAIT;
+        break;
+    case Kind::FutexWake:
+        op = FUTEX_WAKE;
+        break;
+    default:
+        return;
+    }
+    if (op >= kOpCount)
+        return;
+
+    AddressStats &stats = address(event.pid, event.args[0]);
+    ++stats.ops[op];
+
+    switch (op)
+    {
+    case FUTEX_WAIT:
+    case FUTEX_WAIT_BITSET:
+    case FUTEX_WAIT_REQUEUE_PI:
+    case FUTEX_LOCK_PI:
+    case FUTEX_LOCK_PI2:
+    {
+        // Só as esperas que dormiram contam tempo: as que terminaram por wake, por tempo
+        // limite ou por um sinal. As demais falhas retornam sem dormir.
+        if (event.ret == -EAGAIN)
+        {
+            ++stats.eagain;
+            return;
+        }
+        if (event.ret == -ETIMEDOUT)
+            ++stats.timeouts;
+        else if (event.ret < 0 && !interrupted(event.ret))
+            return;
+
+        std::uint64_t duration =
+            event.exit_ns > event.entry_ns ? event.exit_ns - event.entry_ns : 0;
+        ++stats.waits;
+        stats.wait_ns += duration;
+        stats.max_wait_ns = std::max(stats.max_wait_ns, duration);
+        stats.waiters.insert(event.tid);
+
+        ThreadStats &thread = m_threads[{event.pid, event.tid}];
+        thread.pid = event.pid;
+        thread.tid = event.tid;
+        ++thread.waits;
+        thread.wait_ns += duration;
+        thread.max_wait_ns = std::max(thread.max_wait_ns, duration);
+        thread.by_address[event.args[0]] += duration;
+        break;
+    }
+
+    case FUTEX_WAKE:
+    case FUTEX_WAKE_BITSET:
+    case FUTEX_WAKE_OP:
+    case FUTEX_REQUEUE:
+    case FUTEX_CMP_REQUEUE:
+    case FUTEX_CMP_REQUEUE_PI:
+        // O retorno é a quantidade de threads acordadas (ou movidas para outro endereço).
+        ++stats.wakes;
+        if (event.ret > 0)
+            stats.woken += static_cast<std::size_t>(event.ret);
+        else if (event.ret == 0)
+            ++stats.empty_wakes;
+        break;
+
+    case FUTEX_UNLOCK_PI:
+        ++stats.wakes;
+        break;
+
+    default:
+        break;
+    }
+}
+
+void FutexProfiler::on_process_event(const ProcessEvent &event)
+{
+    // Uma thread que terminou sai do mapa, para que um TID reutilizado comece do zero; as suas
+    // estatísticas continuam no relatório.
+    if (event.type == ProcessEventType::Exit)
+    {
+        auto it = m_threads.find({event.pid, event.tid});
+        if (it != m_threads.end())
+        {
+            m_exited_threads.push_back(std::move(it->second));
+            m_threads.erase(it);
+        }
+    }
+    // Os endereços já resolvidos continuam válidos; só o cache dos mapeamentos é descartado.
+    if (event.type == ProcessEventType::Exec ||
+        (event.type == ProcessEventType::Exit && event.tid == event.pid))
+        m_maps.forget(event.pid);
+}
+
+void FutexProfiler::on_finish()
+{
+    std::size_t waits = 0;
+    std::uint64_t wait_ns = 0;
+    std::vector<const std::pair<const std::pair<pid_t, std::uint64_t>, AddressStats> *> addresses;
+    for (const auto &entry : m_addresses)
+    {
+        waits += entry.second.waits;
+        wait_ns += entry.second.wait_ns;
+        addresses.push_back(&entry);
+    }
+    spdlog::info("FUTEX_REPORT {} endereço(s), {} espera(s), {} esperando em {} thread(s)",
+                 m_addresses.size(), waits, format_duration(wait_ns),
+                 m_threads.size() + m_exited_threads.size());
+
+    // Mais tempo de espera primeiro; empates pela quantidade de esperas e pela ordem do mapa.
+    std::stable_sort(addresses.begin(), addresses.end(), [](const auto *a, const auto *b) {
+        if (a->second.wait_ns != b->second.wait_ns)
+            return a->second.wait_ns > b->second.wait_ns;
+        return a->second.waits > b->second.waits;
+    });
+    if (addresses.size() > m_top_n)
+        addresses.resize(m_top_n);
+    for (std::size_t i = 0; i < addresses.size(); ++i)
+    {
+        const auto &[key, stats] = *addresses[i];
+        std::string ops;
+        for (std::size_t op = 0; op < kOpCount; ++op)
+        {
+            if (stats.ops[op] == 0)
+                continue;
+            if (!ops.empty())
+                ops += ' ';
+            ops += fmt::format("{}={}", kOpNames[op], stats.ops[op]);
+        }
+        spdlog::info("FUTEX_TOP #{} [PID:{}] {} espera={} em {} espera(s) (máx {}, {} thread(s)), "
+                     "{} EAGAIN, {} timeout(s); {} wake(s) acordaram {}, {} sem ninguém; {}",
+                     i + 1, key.first, stats.location, format_duration(stats.wait_ns),
+                     stats.waits, format_duration(stats.max_wait_ns), stats.waiters.size(),
+                     stats.eagain, stats.timeouts, stats.wakes, stats.woken, stats.empty_wakes,
+                     ops);
+    }
+
+    std::vector<const ThreadStats *> threads;
+    for (const ThreadStats &stats : m_exited_threads)
+        threads.push_back(&stats);
+    for (const auto &entry : m_threads)
+        threads.push_back(&entry.second);
+    std::stable_sort(threads.begin(), threads.end(),
+                     [](const auto *a, const auto *b) { return a->wait_ns > b->wait_ns; });
+    if (threads.size() > m_top_n)
+        threads.resize(m_top_n);
+    for (std::size_t i = 0; i < threads.size(); ++i)
+    {
+        const ThreadStats &stats = *threads[i];
+        auto hottest = std::max_element(
+            stats.by_address.begin(), stats.by_address.end(),
+            [](const auto &a, const auto &b) { return a.second < b.second; });
+        // Toda espera contada passou por address(), então o endereço está no mapa.
+        auto location = m_addresses.find({stats.pid, hottest->first});
+        spdlog::info("FUTEX_THREAD #{} [PID:{} TID:{}] espera={} em {} espera(s) (máx {}); "
+                     "mais quente {}",
+                     i + 1, stats.pid, stats.tid, format_duration(stats.wait_ns), stats.waits,
+                     format_duration(stats.max_wait_ns),
+                     location != m_addresses.end() ? location->second.location
+                                                   : fmt::format("{:#x}", hottest->first));
+    }
+}
+
+FutexProfiler::AddressStats &FutexProfiler::address(pid_t pid, std::uint64_t uaddr)
+{
+    auto [it, inserted] = m_addresses.try_emplace({pid, uaddr});
+    if (inserted)
+    {
+        // O endereço é resolvido enquanto o processo ainda existe.
+        std::string location = m_maps.resolve(pid, uaddr);
+        it->second.location = fmt::format("{:#x}", uaddr);
+        if (location != it->second.location)
+            it->second.location += " (" + location + ")";
+    }
+    return it->second;
+}
@@ -0,0 +1,346 @@
+#include "Metrics.h" // Headers do projeto
+#include "Syscall.h" // Headers do projeto
+
+#include "spdlog/spdlog.h" // Usado para registrar erros do servidor e formatar o texto
+
+#include <cerrno>  // Usado pelo errno das chamadas de socket
+#include <cstdlib> // Usado pelo strtol da porta
+#include <cstring> // Usado pelo strerror e pelo strerrorname_np
+
+#include <arpa/inet.h>   // Usado pelo inet_pton para o endereço TCP
+#include <netinet/in.h>  // Usado pela struct sockaddr_in
+#include <poll.h>        // Usado para aguardar conexões ou o pedido de encerramento
+#include <sys/eventfd.h> // Usado pelo eventfd que acorda a thread do servidor
+#include <sys/socket.h>  // Usado pelas chamadas de socket
+#include <sys/un.h>      // Usado pela struct sockaddr_un
+#include <unistd.h>      // Usado pelo close, read e write
+
+/// @brief Tempo máximo esperando o pedido HTTP de um cliente, em milissegundos.
+static constexpr int kClientTimeoutMs = 1000;
+
+/**
+ * @brief Abre um socket de escuta a partir de "127.0.0.1:<porta>" ou de um caminho Unix.
+ * @param listen O endereço de escuta.
+ * @param unix_path Recebe o caminho do socket Unix, quando for o caso.
+ * @return O descritor do socket, ou -1 em caso de erro.
+ */
+static int open_listen_socket(const std::string &listen, std::string &unix_path)
+{
+    const auto colon = listen.rfind(':');
+    if (colon != std::string::npos && listen.find('/') == std::string::npos)
+    {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        long port = std::strtol(listen.c_str() + colon + 1, nullptr, 10);
+        if (port <= 0 || port > 65535 ||
+            inet_pton(AF_INET, listen.substr(0, colon).c_str(), &addr.sin_addr) != 1)
+        {
+            spdlog::error("Endereço de métricas inválido: {}", listen);
+            return -1;
+        }
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int one = 1;
+        if (fd >= 0)
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+            ::listen(fd, 16) < 0)
+        {
+            spdlog::error("Não foi possível escutar em {}: {}", listen, strerror(errno));
+            if (fd >= 0)
+                close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (listen.size() >= sizeof(addr.sun_path))
+    {
+        spdlog::error("Caminho do socket de métricas muito longo: {}", listen);
+        return -1;
+    }
+    std::strncpy(addr.sun_path, listen.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(listen.c_str()); // Remove um socket antigo deixado por uma execução anterior.
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+        ::listen(fd, 16) < 0)
+    {
+        spdlog::error("Não foi possível escutar em {}: {}", listen, strerror(errno));
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    unix_path = listen;
+    return fd;
+}
+
+/**
+ * @brief Retorna o nome simbólico de um errno (ex: "ENOENT"), ou o número se não houver.
+ */
+static std::string errno_name(int err)
+{
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 32)
+    if (const char *name = strerrorname_np(err))
+        return name;
+#endif
+    return std::to_string(err);
+}
+
+MetricsExporter::MetricsExporter(const std::string &listen)
+{
+    m_listen_fd = open_listen_socket(listen, m_unix_path);
+    if (m_listen_fd < 0)
+        return;
+    m_wake_fd = eventfd(0, EFD_CLOEXEC);
+    m_thread = std::thread(&MetricsExporter::serve, this);
+    spdlog::info("Servindo métricas OpenMetrics em {}", listen);
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    if (m_thread.joinable())
+    {
+        uint64_t one = 1;
+        (void)!write(m_wake_fd, &one, sizeof(one));
+        m_thread.join();
+    }
+    if (m_wake_fd >= 0)
+        close(m_wake_fd);
+    if (m_listen_fd >= 0)
+        close(m_listen_fd);
+    if (!m_unix_path.empty())
+        unlink(m_unix_path.c_str());
+}
+
+MetricsExporter::PidCounters *MetricsExporter::find_pid(pid_t pid)
+{
+    const auto it = m_slot_by_pid.find(pid);
+    if (it != m_slot_by_pid.end())
+        return &m_pids[it->second];
+
+    std::size_t index;
+    if (!m_free_slots.empty())
+    {
+        index = m_free_slots.back();
+        m_free_slots.pop_back();
+    }
+    else if (m_used_slots < kMaxPids)
+    {
+        index = m_used_slots++;
+    }
+    else
+    {
+        return nullptr;
+    }
+    // Os contadores já estão zerados; publicar o PID com 'release' garante que o servidor nunca
+    // veja a entrada pela metade.
+    m_slot_by_pid.emplace(pid, index);
+    m_pids[index].pid.store(pid, std::memory_order_release);
+    return &m_pids[index];
+}
+
+void MetricsExporter::on_process_event(const ProcessEvent &event)
+{
+    // Só o término do líder libera a entrada; ele é reportado depois das demais threads.
+    if (event.type != ProcessEventType::Exit || event.tid != event.pid)
+        return;
+    const auto it = m_slot_by_pid.find(event.pid);
+    if (it == m_slot_by_pid.end())
+        return;
+
+    // A série do processo some da próxima coleta. A entrada é despublicada antes de ser zerada,
+    // para que uma coleta concorrente não mostre o PID com contadores de outro processo.
+    PidCounters &slot = m_pids[it->second];
+    slot.pid.store(0, std::memory_order_release);
+    slot.calls.store(0, std::memory_order_relaxed);
+    slot.errors.store(0, std::memory_order_relaxed);
+    m_free_slots.push_back(it->second);
+    m_slot_by_pid.erase(it);
+}
+
+void MetricsExporter::on_syscall_exit(const SyscallEvent &event)
+{
+    constexpr auto relaxed = std::memory_order_relaxed;
+    bool failed = event.ret < 0 && event.ret >= -4095; // Faixa de errno do kernel.
+
+    if (event.nr >= 0 && static_cast<std::size_t>(event.nr) < kMaxSyscalls)
+    {
+        SyscallCounters &counters = m_syscalls[event.nr];
+        std::uint64_t duration = event.exit_ns - event.entry_ns;
+        std::size_t bucket = 0;
+        while (bucket < kBucketsNs.size() && duration > kBucketsNs[bucket])
+            ++bucket;
+        counters.buckets[bucket].fetch_add(1, relaxed);
+        counters.duration_ns.fetch_add(duration, relaxed);
+        if (failed)
+            counters.errors.fetch_add(1, relaxed);
+    }
+
+    if (PidCounters *pid = find_pid(event.pid))
+    {
+        pid->calls.fetch_add(1, relaxed);
+        if (failed)
+            pid->errors.fetch_add(1, relaxed);
+    }
+    else
+    {
+        m_other_pid_calls.fetch_add(1, relaxed);
+        if (failed)
+            m_other_pid_errors.fetch_add(1, relaxed);
+    }
+
+    if (failed && static_cast<std::size_t>(-event.ret) < kMaxErrno)
+        m_errnos[-event.ret].fetch_add(1, relaxed);
+}
+
+std::string MetricsExporter::render() const
+{
+    constexpr auto relaxed = std::memory_order_relaxed;
+    fmt::memory_buffer out;
+    auto append = [&out](auto &&...args)
+    { fmt::format_to(std::back_inserter(out), std::forward<decltype(args)>(args)...); };
+
+    // Syscalls que nunca foram vistas são omitidas para manter a coleta pequena.
+    append("# TYPE tracerc_syscalls counter\n"
+           "# HELP tracerc_syscalls Completed system calls.\n");
+    for (std::size_t nr = 0; nr < kMaxSyscalls; ++nr)
+    {
+        std::uint64_t calls = 0;
+        for (const auto &bucket : m_syscalls[nr].buckets)
+            calls += bucket.load(relaxed);
+        if (calls == 0)
+            continue;
+        const auto info = Syscall::get_syscall_info(static_cast<long>(nr));
+        append("tracerc_syscalls_total{{syscall=\"{}\"}} {}\n",
+               info ? info->name : std::to_string(nr), calls);
+    }
+
+    append("# TYPE tracerc_syscall_errors counter\n"
+           "# HELP tracerc_syscall_errors System calls that returned an error.\n");
+    for (std::size_t nr = 0; nr < kMaxSyscalls; ++nr)
+    {
+        std::uint64_t errors = m_syscalls[nr].errors.load(relaxed);
+        if (errors == 0)
+            continue;
+        const auto info = Syscall::get_syscall_info(static_cast<long>(nr));
+        append("tracerc_syscall_errors_total{{syscall=\"{}\"}} {}\n",
+               info ? info->name : std::to_string(nr), errors);
+    }
+
+    append("# TYPE tracerc_syscall_duration_seconds histogram\n"
+           "# HELP tracerc_syscall_duration_seconds Time between syscall entry and exit stops.\n");
+    for (std::size_t nr = 0; nr < kMaxSyscalls; ++nr)
+    {
+        const SyscallCounters &counters = m_syscalls[nr];
+        std::uint64_t cumulative = 0;
+        std::array<std::uint64_t, kBucketsNs.size() + 1> values{};
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            cumulative += counters.buckets[i].load(relaxed);
+            values[i] = cumulative;
+        }
+        if (cumulative == 0)
+            continue;
+        const auto info = Syscall::get_syscall_info(static_cast<long>(nr));
+        std::string name = info ? info->name : std::to_string(nr);
+        for (std::size_t i = 0; i < kBucketsNs.size(); ++i)
+            append("tracerc_syscall_duration_seconds_bucket{{syscall=\"{}\",le=\"{}\"}} {}\n",
+                   name, kBucketsNs[i] / 1e9, values[i]);
+        append("tracerc_syscall_duration_seconds_bucket{{syscall=\"{}\",le=\"+Inf\"}} {}\n", name,
+               cumulative);
+        append("tracerc_syscall_duration_seconds_count{{syscall=\"{}\"}} {}\n", name, cumulative);
+        append("tracerc_syscall_duration_seconds_sum{{syscall=\"{}\"}} {}\n", name,
+               counters.duration_ns.load(relaxed) / 1e9);
+    }
+
+    append("# TYPE tracerc_process_syscalls counter\n"
+           "# HELP tracerc_process_syscalls Completed system calls per traced process.\n");
+    for (const PidCounters &slot : m_pids)
+    {
+        pid_t pid = slot.pid.load(std::memory_order_acquire);
+        if (pid != 0)
+            append("tracerc_process_syscalls_total{{pid=\"{}\"}} {}\n", pid,
+                   slot.calls.load(relaxed));
+    }
+    if (std::uint64_t other = m_other_pid_calls.load(relaxed))
+        append("tracerc_process_syscalls_total{{pid=\"other\"}} {}\n", other);
+
+    append("# TYPE tracerc_process_syscall_errors counter\n"
+           "# HELP tracerc_process_syscall_errors Failed system calls per traced process.\n");
+    for (const PidCounters &slot : m_pids)
+    {
+        pid_t pid = slot.pid.load(std::memory_order_acquire);
+        if (pid != 0)
+            append("tracerc_process_syscall_errors_total{{pid=\"{}\"}} {}\n", pid,
+                   slot.errors.load(relaxed));
+    }
+    if (std::uint64_t other = m_other_pid_errors.load(relaxed))
+        append("tracerc_process_syscall_errors_total{{pid=\"other\"}} {}\n", other);
+
+    append("# TYPE tracerc_errno counter\n"
+           "# HELP tracerc_errno Failed system calls per error code.\n");
+    for (std::size_t err = 1; err < kMaxErrno; ++err)
+    {
+        if (std::uint64_t count = m_errnos[err].load(relaxed))
+            append("tracerc_errno_total{{errno=\"{}\"}} {}\n", errno_name(static_cast<int>(err)),
+                   count);
+    }
+
+    append("# EOF\n");
+    return fmt::to_string(out);
+}
+
+void MetricsExporter::serve()
+{
+    while (true)
+    {
+        pollfd fds[2] = {{m_listen_fd, POLLIN, 0}, {m_wake_fd, POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        if (fds[1].revents)
+            break; // Pedido de encerramento.
+        if (!(fds[0].revents & POLLIN))
+            continue;
+
+        int client = accept4(m_listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0)
+            continue;
+
+        // Lê o pedido apenas até o fim dos cabeçalhos. Qualquer caminho recebe as métricas.
+        std::string request;
+        char buf[1024];
+        while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192)
+        {
+            pollfd client_fd{client, POLLIN, 0};
+            if (poll(&client_fd, 1, kClientTimeoutMs) <= 0)
+                break;
+            ssize_t got = read(client, buf, sizeof(buf));
+            if (got <= 0)
+                break;
+            request.append(buf, got);
+        }
+
+        std::string body = render();
+        std::string response = fmt::format(
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+            "Content-Length: {}\r\n"
+            "Connection: close\r\n\r\n{}",
+            body.size(), body);
+        std::size_t sent = 0;
+        while (sent < response.size())
+        {
+            ssize_t n = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0)
+                break;
+            sent += n;
+        }
+        close(client);
+    }
+}
@@ -0,0 +1,301 @@
+#include "OverheadGovernor.h" // Headers do projeto
+#include "Syscall.h"          // Headers do projeto
+
+#include "spdlog/spdlog.h" // Usado para registrar cada ajuste
+
+#include <algorithm> // Usado pela ordenação das syscalls e threads mais ativas
+#include <cmath>     // Usado pelo std::abs da variação da fração
+#include <string>    // Usado pela lista de threads amostradas
+#include <utility>   // Usado pelos pares (taxa, thread)
+
+/// @brief Menor fração rastreada de um período de amostragem.
+static constexpr double kMinFraction = 0.01;
+
+/**
+ * @brief Retorna o nome de uma syscall para o log.
+ * @param nr O número da syscall.
+ * @return O nome, ou o número se ele não está na tabela.
+ */
+static std::string syscall_name(long nr)
+{
+    const auto info = Syscall::get_syscall_info(nr);
+    return info ? info->name : std::to_string(nr);
+}
+
+bool OverheadGovernor::parse_spec(const std::string &spec, std::uint64_t &budget,
+                                  bool &sampling, std::string &error)
+{
+    const auto comma = spec.find(',');
+    sampling = false;
+    if (comma != std::string::npos)
+    {
+        if (spec.substr(comma + 1) != "sample")
+        {
+            error = "unknown mode '" + spec.substr(comma + 1) + "', expected 'sample'";
+            return false;
+        }
+        sampling = true;
+    }
+    const std::string number = spec.substr(0, comma);
+    try
+    {
+        std::size_t used = 0;
+        budget = std::stoull(number, &used);
+        if (used != number.size())
+            budget = 0;
+    }
+    catch (const std::exception &)
+    {
+        budget = 0;
+    }
+    if (budget == 0 || number.find('-') != std::string::npos)
+    {
+        error = "budget must be a positive number of stops per second, got '" + number + "'";
+        return false;
+    }
+    return true;
+}
+
+OverheadGovernor::OverheadGovernor(std::uint64_t budget, bool sampling, std::uint64_t now_ns)
+    : m_budget(budget), m_sampling(sampling), m_window_start(now_ns), m_period_start(now_ns),
+      m_deadline(now_ns + kWindowNs)
+{
+    // As tabelas cobrem todos os números conhecidos, como nos demais consumidores.
+    std::size_t count =
+        Syscall::g_syscall_map.empty() ? 0 : Syscall::g_syscall_map.rbegin()->first + 1;
+    m_stops_by_nr.assign(count, 0);
+    m_count_only.assign(count, false);
+    m_counted.assign(count, 0);
+    spdlog::info("GOVERNOR orçamento de {} paradas/s; amostragem de threads {}", budget,
+                 sampling ? "permitida" : "desativada");
+}
+
+bool OverheadGovernor::record(pid_t tid, long nr)
+{
+    // Cada syscall rastreada custa duas paradas: a entrada e a saída.
+    m_stops_by_tid[tid] += 2;
+    if (nr < 0 || static_cast<std::size_t>(nr) >= m_stops_by_nr.size())
+    {
+        return false;
+    }
+    m_stops_by_nr[nr] += 2;
+    if (!m_count_only[nr])
+    {
+        return false;
+    }
+    ++m_counted[nr];
+    return true;
+}
+
+std::vector<pid_t> OverheadGovernor::tick(std::uint64_t now_ns)
+{
+    std::vector<pid_t> wake;
+    if (now_ns >= m_window_start + kWindowNs)
+    {
+        evaluate(now_ns, wake);
+        m_window_start = now_ns;
+        std::fill(m_stops_by_nr.begin(), m_stops_by_nr.end(), 0);
+        m_stops_by_tid.clear();
+    }
+
+    m_deadline = m_window_start + kWindowNs;
+    if (m_sampled.empty())
+    {
+        return wake;
+    }
+
+    // Fase de amostragem: o período começa rastreado e passa para o PTRACE_CONT depois da
+    // fração. As threads que estavam fora voltam com um SIGSTOP no início do próximo período; o
+    // SIGSTOP interrompe a syscall bloqueada em que a thread estiver (ver kPeriodNs).
+    if (now_ns >= m_period_start + kPeriodNs)
+    {
+        m_period_start = now_ns;
+    }
+    const auto traced_ns = static_cast<std::uint64_t>(m_fraction * kPeriodNs);
+    const bool in_phase = now_ns < m_period_start + traced_ns;
+    if (in_phase && !m_in_phase)
+    {
+        wake.insert(wake.end(), m_sampled.begin(), m_sampled.end());
+    }
+    m_in_phase = in_phase;
+    m_deadline = std::min(m_deadline, m_period_start + (in_phase ? traced_ns : kPeriodNs));
+    return wake;
+}
+
+void OverheadGovernor::forget(pid_t tid)
+{
+    m_stops_by_tid.erase(tid);
+    if (m_sampled.erase(tid) && m_sampled.empty())
+    {
+        spdlog::info("GOVERNOR as threads amostradas terminaram; amostragem desfeita");
+        m_fraction = 1.0;
+        m_in_phase = true;
+        ++m_adjustments;
+    }
+}
+
+double OverheadGovernor::full_rate(pid_t tid, std::uint64_t stops, double seconds) const
+{
+    double rate = stops / seconds;
+    return m_sampled.count(tid) ? rate / m_fraction : rate;
+}
+
+void OverheadGovernor::evaluate(std::uint64_t now_ns, std::vector<pid_t> &wake)
+{
+    const double seconds = static_cast<double>(now_ns - m_window_start) / 1e9;
+    const double budget = static_cast<double>(m_budget);
+
+    // A taxa estimada inclui o que as threads amostradas fariam se fossem rastreadas o tempo
+    // todo, senão a amostragem seria desfeita assim que fizesse efeito.
+    std::vector<std::pair<double, pid_t>> threads;
+    double total = 0;
+    for (const auto &[tid, stops] : m_stops_by_tid)
+    {
+        threads.emplace_back(full_rate(tid, stops, seconds), tid);
+        total += threads.back().first;
+    }
+    bool any_count_only = std::find(m_count_only.begin(), m_count_only.end(), true) !=
+                          m_count_only.end();
+
+    if (total > budget && !any_count_only)
+    {
+        // Primeiro nível: as syscalls mais frequentes, até que o resto caiba no orçamento.
+        std::vector<std::pair<std::uint64_t, long>> hottest;
+        for (std::size_t nr = 0; nr < m_stops_by_nr.size(); ++nr)
+        {
+            if (m_stops_by_nr[nr] > 0)
+            {
+                hottest.emplace_back(m_stops_by_nr[nr], static_cast<long>(nr));
+            }
+        }
+        std::sort(hottest.rbegin(), hottest.rend());
+        double rest = total;
+        for (const auto &[stops, nr] : hottest)
+        {
+            m_count_only[nr] = true;
+            rest -= stops / seconds;
+            ++m_adjustments;
+            spdlog::info("GOVERNOR {:.0f} paradas/s acima do orçamento de {}: {} passa a ser só "
+                         "contada ({:.0f} paradas/s)",
+                         total, m_budget, syscall_name(nr), stops / seconds);
+            if (rest <= budget)
+            {
+                break;
+            }
+        }
+        return;
+    }
+
+    if (total > budget && !m_sampling)
+    {
+        // Sem a opção explícita o governador para no primeiro nível: a amostragem muda o que o
+        // processo vê (EINTR), então nunca é ligada por conta própria.
+        if (!m_sampling_hint_logged)
+        {
+            m_sampling_hint_logged = true;
+            spdlog::info("GOVERNOR {:.0f} paradas/s ainda acima do orçamento de {}; use "
+                         "--overhead-budget {},sample para amostrar as threads mais ativas",
+                         total, m_budget, m_budget);
+        }
+        return;
+    }
+
+    if (total > budget)
+    {
+        // Segundo nível: amostra as threads mais ativas até que as demais fiquem abaixo da metade
+        // do orçamento, e rastreia as amostradas só na fração que cabe no resto.
+        std::sort(threads.rbegin(), threads.rend());
+        std::set<pid_t> sampled;
+        double sampled_rate = 0;
+        double rest = total;
+        for (const auto &[rate, tid] : threads)
+        {
+            if (!sampled.empty() && rest <= budget / 2)
+            {
+                break;
+            }
+            sampled.insert(tid);
+            sampled_rate += rate;
+            rest -= rate;
+        }
+        double fraction = std::clamp((budget - rest) / sampled_rate, kMinFraction, 1.0);
+
+        // Pequenas variações da taxa não mudam a amostragem, para o log continuar legível.
+        if (sampled == m_sampled && std::abs(fraction - m_fraction) < m_fraction / 10)
+        {
+            return;
+        }
+        if (!m_in_phase)
+        {
+            wake.insert(wake.end(), m_sampled.begin(), m_sampled.end());
+        }
+        m_sampled = std::move(sampled);
+        m_fraction = fraction;
+        m_in_phase = true;
+        m_period_start = now_ns;
+        ++m_adjustments;
+
+        std::string list;
+        for (const auto &[rate, tid] : threads)
+        {
+            if (m_sampled.count(tid))
+            {
+                list += fmt::format("{}TID {} ({:.0f}/s)", list.empty() ? "" : ", ", tid, rate);
+            }
+        }
+        spdlog::warn("GOVERNOR {:.0f} paradas/s acima do orçamento de {}: amostrando {} "
+                     "thread(s) em {:.1f}% de cada período de {} ms: {}. Cada volta ao "
+                     "rastreamento usa um SIGSTOP, que pode fazer epoll_wait, semop e "
+                     "sigtimedwait retornarem EINTR nessas threads",
+                     total, m_budget, m_sampled.size(), m_fraction * 100, kPeriodNs / 1000000,
+                     list);
+        return;
+    }
+
+    if (total >= budget / 2)
+    {
+        return;
+    }
+
+    // Abaixo da metade do orçamento, os ajustes são desfeitos do último para o primeiro.
+    if (!m_sampled.empty())
+    {
+        if (!m_in_phase)
+        {
+            wake.insert(wake.end(), m_sampled.begin(), m_sampled.end());
+        }
+        spdlog::info("GOVERNOR {:.0f} paradas/s abaixo de {}: {} thread(s) voltam a ser "
+                     "rastreadas continuamente",
+                     total, m_budget / 2, m_sampled.size());
+        m_sampled.clear();
+        m_fraction = 1.0;
+        m_in_phase = true;
+        ++m_adjustments;
+        return;
+    }
+    for (std::size_t nr = 0; nr < m_count_only.size(); ++nr)
+    {
+        if (m_count_only[nr])
+        {
+            m_count_only[nr] = false;
+            ++m_adjustments;
+            spdlog::info("GOVERNOR {:.0f} paradas/s abaixo de {}: {} volta a ser registrada ({} "
+                         "chamada(s) só contadas até agora)",
+                         total, m_budget / 2, syscall_name(nr), m_counted[nr]);
+        }
+    }
+}
+
+void OverheadGovernor::report() const
+{
+    spdlog::info("GOVERNOR_REPORT {} ajuste(s); amostragem {}", m_adjustments,
+                 m_sampled.empty() ? "inativa" : "ativa");
+    for (std::size_t nr = 0; nr < m_counted.size(); ++nr)
+    {
+        if (m_counted[nr] > 0)
+        {
+            spdlog::info("GOVERNOR_REPORT {} só contada em {} chamada(s)",
+                         syscall_name(static_cast<long>(nr)), m_counted[nr]);
+        }
+    }
+}
@@ -0,0 +1,371 @@
+#include "PatternAdvisor.h" // Headers do projeto
+#include "ProcessMemory.h"  // Headers do projeto
+#include "Syscall.h"        // Headers do projeto
+
+#include "spdlog/spdlog.h" // Usado para registrar o relatório
+
+#include <algorithm> // Usado pelo std::find nos exemplos
+
+#include <fcntl.h>    // Usado pelo AT_EMPTY_PATH
+#include <sys/mman.h> // Usado pelo MAP_ANONYMOUS
+#include <sys/time.h> // Usado pela struct timeval
+#include <time.h>     // Usado pela struct timespec
+
+/// @brief Chamadas de E/S abaixo deste tamanho são consideradas pequenas.
+static constexpr unsigned long long kTinyIoBytes = 512;
+/// @brief Chamadas pequenas seguidas no mesmo descritor que caracterizam um laço.
+static constexpr std::size_t kTinyIoStreak = 8;
+/// @brief Polls sem espera e sem eventos seguidos que caracterizam uma espera ocupada.
+static constexpr std::size_t kPollBusyStreak = 16;
+/// @brief Intervalo máximo entre dois polls de uma mesma espera ocupada.
+static constexpr std::uint64_t kPollBusyGapNs = 1000000ULL;
+/// @brief Chamadas de brk/mmap/munmap por segundo acima das quais há rotatividade excessiva.
+static constexpr std::size_t kMemoryCallsPerSecond = 200;
+/// @brief Chamadas de sincronização por segundo acima das quais há uma tempestade de fsync.
+static constexpr std::size_t kSyncCallsPerSecond = 10;
+/// @brief Caminhos distintos lembrados por processo, para limitar a memória.
+static constexpr std::size_t kMaxPathsPerProcess = 65536;
+/// @brief Exemplos guardados por padrão.
+static constexpr std::size_t kExamplesPerPattern = 3;
+
+/// @brief Nome e sugestão de cada padrão, na mesma ordem de AdvicePattern.
+static const std::pair<const char *, const char *> kPatternText[] = {
+    {"tiny-io", "agrupe as leituras/escritas em buffers maiores (ex: stdio com buffer, writev)"},
+    {"repeated-lookup", "guarde o resultado da consulta ou mantenha o arquivo aberto"},
+    {"fstat-after-open", "evite o fstat se o tipo/tamanho já for conhecido"},
+    {"seek-then-io", "use pread/pwrite, que recebem o deslocamento na mesma chamada"},
+    {"poll-busy-loop", "bloqueie com um tempo limite em vez de consultar sem esperar"},
+    {"memory-churn", "reutilize buffers ou ajuste o alocador (M_MMAP_THRESHOLD, M_TRIM_THRESHOLD)"},
+    {"sync-storm", "agrupe as escritas antes de sincronizar ou sincronize com menos frequência"},
+};
+
+PatternAdvisor::PatternAdvisor()
+{
+    static const std::pair<const char *, Role> kTable[] = {
+        {"read", {Kind::Read, 2}},
+        {"recvfrom", {Kind::Read, 2}},
+        {"write", {Kind::Write, 2}},
+        {"sendto", {Kind::Write, 2}},
+        {"pread64", {Kind::PositionalIo, 2}},
+        {"pwrite64", {Kind::PositionalIo, 2}},
+        {"open", {Kind::Open, 0}},
+        {"creat", {Kind::Open, 0}},
+        {"openat", {Kind::Open, 1}},
+        {"stat", {Kind::PathLookup, 0}},
+        {"lstat", {Kind::PathLookup, 0}},
+        {"access", {Kind::PathLookup, 0}},
+        {"faccessat", {Kind::PathLookup, 1}},
+        {"faccessat2", {Kind::PathLookup, 1}},
+        {"newfstatat", {Kind::StatAt, 3}},
+        {"statx", {Kind::StatAt, 2}},
+        {"fstat", {Kind::Fstat, 0}},
+        {"lseek", {Kind::Lseek, 0}},
+        {"poll", {Kind::PollMs, 2}},
+        {"epoll_wait", {Kind::PollMs, 3}},
+        {"epoll_pwait", {Kind::PollMs, 3}},
+        {"ppoll", {Kind::PollTimespec, 2}},
+        {"pselect6", {Kind::PollTimespec, 4}},
+        {"epoll_pwait2", {Kind::PollTimespec, 3}},
+        {"select", {Kind::PollTimeval, 4}},
+        {"brk", {Kind::Memory, -1}},
+        {"mmap", {Kind::Memory, 3}},
+        {"munmap", {Kind::Memory, -1}},
+        {"mremap", {Kind::Memory, -1}},
+        {"fsync", {Kind::Sync, 0}},
+        {"fdatasync", {Kind::Sync, 0}},
+        {"sync_file_range", {Kind::Sync, 0}},
+        {"msync", {Kind::Sync, 0}},
+        {"syncfs", {Kind::Sync, 0}},
+    };
+    m_role_by_nr = Syscall::table_by_number(kTable, Role{});
+}
+
+/**
+ * @brief Recupera um argumento de caminho dos argumentos formatados na entrada.
+ *
+ * O caminho é lido uma única vez, pelo Tracer, na entrada da syscall: na saída o buffer do
+ * processo já pode ter mudado. Nas syscalls de caminho os demais argumentos são números, então
+ * o caminho é o trecho entre o separador de índice 'index' contado do início e os separadores
+ * dos argumentos restantes contados do fim, mesmo que ele contenha ", ".
+ * @param event O evento com args_str preenchido.
+ * @param index O índice do argumento de caminho.
+ * @return O caminho formatado (entre aspas), ou vazio se os argumentos não foram formatados.
+ */
+static std::string path_argument(const SyscallEvent &event, int index)
+{
+    const auto info = Syscall::get_syscall_info(event.nr);
+    if (!info || event.args_str.empty())
+        return {};
+    std::size_t begin = 0;
+    for (int i = 0; i < index && begin != std::string::npos; ++i)
+    {
+        begin = event.args_str.find(", ", begin);
+        if (begin != std::string::npos)
+            begin += 2;
+    }
+    std::size_t end = event.args_str.size();
+    for (int i = index + 1; i < info->arg_count && end != std::string::npos; ++i)
+        end = end == 0 ? std::string::npos : event.args_str.rfind(", ", end - 1);
+    if (begin == std::string::npos || end == std::string::npos || end < begin)
+        return {};
+    return event.args_str.substr(begin, end - begin);
+}
+
+PatternAdvisor::Role PatternAdvisor::role_of(long nr) const
+{
+    if (nr >= 0 && static_cast<std::size_t>(nr) < m_role_by_nr.size())
+        return m_role_by_nr[nr];
+    return {};
+}
+
+CaptureLevel PatternAdvisor::on_syscall_entry(const SyscallEvent &event)
+{
+    switch (role_of(event.nr).kind)
+    {
+    case Kind::Open:
+    case Kind::PathLookup:
+    case Kind::StatAt:
+        return CaptureLevel::Decoded;
+    case Kind::PollMs:
+    case Kind::PollTimespec:
+    case Kind::PollTimeval:
+        // ppoll, pselect6 e select sobrescrevem o tempo limite com o tempo restante, que é zero
+        // depois de um timeout; por isso ele é lido aqui, antes da chamada.
+        m_threads[event.tid].zero_timeout = zero_timeout(event, role_of(event.nr));
+        return CaptureLevel::Event;
+    default:
+        // Mesmo as syscalls sem papel são vistas, para quebrar os pares (open+fstat, lseek+read).
+        return CaptureLevel::Event;
+    }
+}
+
+void PatternAdvisor::on_syscall_exit(const SyscallEvent &event)
+{
+    Role role = role_of(event.nr);
+    ThreadState &thread = m_threads[event.tid];
+    bool failed = event.ret < 0 && event.ret >= -4095; // Faixa de errno do kernel.
+    auto fd = static_cast<long long>(static_cast<int>(event.args[0]));
+
+    switch (role.kind)
+    {
+    case Kind::Read:
+    case Kind::Write:
+        check_tiny_io(thread, event, role);
+        if (!failed && thread.previous == Kind::Lseek && thread.previous_fd == fd)
+            record(AdvicePattern::SeekThenIo, event, 2, true);
+        break;
+
+    case Kind::PositionalIo:
+        check_tiny_io(thread, event, role);
+        break;
+
+    case Kind::Open:
+    case Kind::PathLookup:
+    {
+        std::string path = path_argument(event, role.arg);
+        if (!path.empty())
+            check_lookup(event, path);
+        break;
+    }
+
+    case Kind::StatAt:
+    {
+        // Com AT_EMPTY_PATH e caminho vazio, a chamada é um fstat do descritor do primeiro
+        // argumento; caso contrário é uma consulta de caminho.
+        std::string path = path_argument(event, 1);
+        if (path == "\"\"" && (event.args[role.arg] & AT_EMPTY_PATH))
+        {
+            if (thread.previous == Kind::Open && thread.previous_fd == fd)
+                record(AdvicePattern::FstatAfterOpen, event, 2, true);
+        }
+        else if (!path.empty())
+        {
+            check_lookup(event, path);
+        }
+        break;
+    }
+
+    case Kind::Fstat:
+        if (thread.previous == Kind::Open && thread.previous_fd == fd)
+            record(AdvicePattern::FstatAfterOpen, event, 2, true);
+        break;
+
+    case Kind::PollMs:
+    case Kind::PollTimespec:
+    case Kind::PollTimeval:
+        check_poll(thread, event);
+        break;
+
+    case Kind::Memory:
+        // mmap de arquivos não é rotatividade de memória; só os mapeamentos anônimos contam.
+        if (role.arg < 0 || (event.args[role.arg] & MAP_ANONYMOUS))
+            check_rate(m_processes[event.pid].memory, AdvicePattern::MemoryChurn,
+                       kMemoryCallsPerSecond, event);
+        break;
+
+    case Kind::Sync:
+        check_rate(m_processes[event.pid].sync, AdvicePattern::SyncStorm, kSyncCallsPerSecond,
+                   event);
+        break;
+
+    case Kind::Lseek:
+    case Kind::None:
+        break;
+    }
+
+    // Lembra a syscall atual para os padrões de pares (open+fstat, lseek+read).
+    thread.previous = failed ? Kind::None : role.kind;
+    thread.previous_fd = role.kind == Kind::Open ? event.ret : fd;
+}
+
+void PatternAdvisor::on_process_event(const ProcessEvent &event)
+{
+    switch (event.type)
+    {
+    case ProcessEventType::Exec:
+        // O novo programa tem outros mapeamentos e outro comportamento.
+        m_maps.forget(event.pid);
+        m_processes.erase(event.pid);
+        m_threads.erase(event.tid);
+        break;
+    case ProcessEventType::Exit:
+        m_threads.erase(event.tid);
+        if (event.tid == event.pid)
+        {
+            m_maps.forget(event.pid);
+            m_processes.erase(event.pid);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void PatternAdvisor::record(AdvicePattern pattern, const SyscallEvent &event, std::size_t calls,
+                            bool new_instance)
+{
+    PatternStats &stats = m_patterns[static_cast<std::size_t>(pattern)];
+    stats.calls += calls;
+    if (!new_instance)
+        return;
+    ++stats.instances;
+    if (stats.examples.size() >= kExamplesPerPattern)
+        return;
+
+    // O local é resolvido agora, enquanto o processo ainda existe.
+    const Syscall::SyscallInfo *info = Syscall::get_syscall_info(event.nr);
+    std::string args = event.args_str.size() > 120 ? event.args_str.substr(0, 117) + "..."
+                                                   : event.args_str;
+    std::string example = fmt::format("[PID:{} TID:{}] {}({}) = {} em {}", event.pid, event.tid,
+                                      info ? info->name : "syscall", args, event.ret,
+                                      m_maps.resolve(event.pid, event.ip));
+    // Ocorrências do mesmo laço costumam ser idênticas; só exemplos distintos são guardados.
+    if (std::find(stats.examples.begin(), stats.examples.end(), example) == stats.examples.end())
+        stats.examples.push_back(std::move(example));
+}
+
+void PatternAdvisor::check_tiny_io(ThreadState &thread, const SyscallEvent &event,
+                                   const Role &role)
+{
+    auto fd = static_cast<long long>(static_cast<int>(event.args[0]));
+    std::size_t &streak = thread.tiny_streaks[fd];
+    if (event.args[role.arg] >= kTinyIoBytes || event.ret <= 0)
+    {
+        streak = 0; // Uma chamada grande (ou um fim de arquivo/erro) encerra a sequência.
+        return;
+    }
+    ++streak;
+    if (streak == kTinyIoStreak)
+        record(AdvicePattern::TinyIo, event, kTinyIoStreak, true);
+    else if (streak > kTinyIoStreak)
+        record(AdvicePattern::TinyIo, event, 1, false);
+}
+
+void PatternAdvisor::check_lookup(const SyscallEvent &event, const std::string &path)
+{
+    if (path == "NULL")
+        return;
+    auto &lookups = m_processes[event.pid].lookups;
+    auto it = lookups.find(path);
+    if (it == lookups.end())
+    {
+        if (lookups.size() < kMaxPathsPerProcess)
+            lookups.emplace(path, 1);
+        return;
+    }
+    // Cada consulta depois da primeira é redundante; a primeira repetição vira o exemplo.
+    ++it->second;
+    record(AdvicePattern::RepeatedLookup, event, 1, it->second == 2);
+}
+
+bool PatternAdvisor::zero_timeout(const SyscallEvent &event, const Role &role)
+{
+    unsigned long long arg = event.args[role.arg];
+    if (role.kind == Kind::PollMs)
+        return static_cast<int>(arg) == 0;
+    if (arg == 0) // Um ponteiro nulo espera indefinidamente.
+        return false;
+    // timespec e timeval têm o mesmo formato em x86-64: dois campos de 64 bits.
+    static_assert(sizeof(timespec) == sizeof(timeval), "formatos diferentes");
+    timespec timeout{1, 0};
+    if (ProcessMemory::read(event.tid, arg, &timeout, sizeof(timeout)) != sizeof(timeout))
+        return false;
+    return timeout.tv_sec == 0 && timeout.tv_nsec == 0;
+}
+
+void PatternAdvisor::check_poll(ThreadState &thread, const SyscallEvent &event)
+{
+    bool zero_timeout = thread.zero_timeout;
+    thread.zero_timeout = false; // Vale só para esta chamada.
+    if (!zero_timeout || event.ret != 0)
+    {
+        thread.poll_streak = 0;
+        return;
+    }
+    // Polls esparsos, mesmo sem espera, não são uma espera ocupada.
+    if (event.entry_ns - thread.last_poll_ns > kPollBusyGapNs)
+        thread.poll_streak = 0;
+    thread.last_poll_ns = event.exit_ns;
+
+    ++thread.poll_streak;
+    if (thread.poll_streak == kPollBusyStreak)
+        record(AdvicePattern::PollBusyLoop, event, kPollBusyStreak, true);
+    else if (thread.poll_streak > kPollBusyStreak)
+        record(AdvicePattern::PollBusyLoop, event, 1, false);
+}
+
+void PatternAdvisor::check_rate(RateWindow &window, AdvicePattern pattern, std::size_t limit,
+                                const SyscallEvent &event)
+{
+    std::uint64_t second = event.entry_ns / 1000000000ULL;
+    if (second != window.second)
+    {
+        window.second = second;
+        window.calls = 0;
+    }
+    ++window.calls;
+    // A janela que passa do limite conta todas as suas chamadas, e vira uma ocorrência.
+    if (window.calls == limit + 1)
+        record(pattern, event, window.calls, true);
+    else if (window.calls > limit + 1)
+        record(pattern, event, 1, false);
+}
+
+void PatternAdvisor::on_finish()
+{
+    std::size_t found = 0;
+    for (std::size_t i = 0; i < m_patterns.size(); ++i)
+    {
+        const PatternStats &stats = m_patterns[i];
+        if (stats.instances == 0)
+            continue;
+        ++found;
+        const auto &[name, advice] = kPatternText[i];
+        spdlog::info("ADVISOR {}: {} chamada(s) em {} ocorrência(s); {}", name, stats.calls,
+                     stats.instances, advice);
+        for (const std::string &example : stats.examples)
+            spdlog::info("ADVISOR_EXAMPLE {} {}", name, example);
+    }
+    if (found == 0)
+        spdlog::info("ADVISOR nenhum padrão ineficiente encontrado");
+}
@@ -0,0 +1,198 @@
+#include "PayloadCapture.h" // Headers do projeto
+#include "ProcessMemory.h"  // Headers do projeto
+#include "Syscall.h"        // Headers do projeto
+
+#include "spdlog/spdlog.h" // Usado para registrar erros ao abrir o arquivo
+
+#include <algorithm> // Usado pelo std::min
+#include <map>       // Usado pela tabela de buffers de dados
+#include <sstream>   // Usado para separar a lista de syscalls
+
+#include <sys/uio.h> // Usado pela struct iovec e pela flag RWF_NOWAIT
+
+/// @brief Quantidade máxima de struct iovec lidas de uma chamada readv/writev.
+static constexpr std::size_t kMaxIovecs = 64;
+
+const PayloadCapture::DataBuffer *PayloadCapture::find_data_buffer(long nr)
+{
+    // Tabela por nome, convertida para números de syscall na primeira chamada.
+    static const std::map<long, DataBuffer> table = []
+    {
+        static const std::pair<const char *, DataBuffer> kByName[] = {
+            {"read", {1, 2, true, false, -1}},      {"pread64", {1, 2, true, false, -1}},
+            {"recvfrom", {1, 2, true, false, -1}},  {"readv", {1, 2, true, true, -1}},
+            {"preadv", {1, 2, true, true, -1}},     {"preadv2", {1, 2, true, true, 5}},
+            {"write", {1, 2, false, false, -1}},    {"pwrite64", {1, 2, false, false, -1}},
+            {"sendto", {1, 2, false, false, -1}},   {"writev", {1, 2, false, true, -1}},
+            {"pwritev", {1, 2, false, true, -1}},   {"pwritev2", {1, 2, false, true, 5}},
+        };
+        std::map<long, DataBuffer> out;
+        for (const auto &[nr, info] : Syscall::g_syscall_map)
+            for (const auto &[name, desc] : kByName)
+                if (info.name == name)
+                    out[nr] = desc;
+        return out;
+    }();
+    const auto it = table.find(nr);
+    return it != table.end() ? &it->second : nullptr;
+}
+
+bool PayloadCapture::captures_at_exit(const SyscallEvent &event, const DataBuffer &desc)
+{
+    // Com RWF_NOWAIT, pwritev2 falha com EAGAIN (ou escreve só uma parte) em vez de bloquear.
+    return desc.kernel_writes ||
+           (desc.flags_arg >= 0 && (event.args[desc.flags_arg] & RWF_NOWAIT) != 0);
+}
+
+bool PayloadCapture::parse_spec(const std::string &spec, std::set<long> &nrs,
+                                std::size_t &max_bytes, std::string &error)
+{
+    const auto colon = spec.rfind(':');
+    if (colon == std::string::npos)
+    {
+        error = "expected <syscalls>:<max-bytes>";
+        return false;
+    }
+    try
+    {
+        max_bytes = std::stoul(spec.substr(colon + 1));
+    }
+    catch (const std::exception &)
+    {
+        error = "invalid max-bytes '" + spec.substr(colon + 1) + "'";
+        return false;
+    }
+
+    // Cada nome da lista precisa ser uma syscall conhecida que transfere dados por um buffer.
+    std::stringstream names(spec.substr(0, colon));
+    std::string name;
+    while (std::getline(names, name, ','))
+    {
+        long found = Syscall::find_syscall_number(name);
+        if (found < 0 || !find_data_buffer(found))
+        {
+            error = "syscall '" + name + "' has no data buffer to capture";
+            return false;
+        }
+        nrs.insert(found);
+    }
+    if (nrs.empty())
+    {
+        error = "no syscalls selected";
+        return false;
+    }
+    return true;
+}
+
+PayloadCapture::PayloadCapture(std::set<long> nrs, std::size_t max_bytes, const std::string &path)
+    : m_max_bytes(max_bytes), m_file(path, std::ios::binary | std::ios::trunc),
+      m_buffer(max_bytes)
+{
+    for (long nr : nrs)
+    {
+        if (nr >= static_cast<long>(m_enabled.size()))
+            m_enabled.resize(nr + 1, false);
+        m_enabled[nr] = true;
+    }
+    if (!m_file)
+    {
+        spdlog::error("Não foi possível abrir o arquivo de payloads {}", path);
+        m_enabled.clear(); // Sem arquivo, nenhuma cópia é feita.
+        return;
+    }
+    spdlog::info("Capturando payloads em {} (máximo de {} bytes por chamada)", path, max_bytes);
+}
+
+void PayloadCapture::capture_entry(SyscallEvent &event, bool defer)
+{
+    event.payload_len = 0;
+    m_pending.erase(event.tid);
+    if (event.nr < 0 || static_cast<std::size_t>(event.nr) >= m_enabled.size() ||
+        !m_enabled[event.nr])
+        return;
+    const DataBuffer *desc = find_data_buffer(event.nr);
+    if (captures_at_exit(event, *desc))
+        return;
+    // Em chamadas com iovec o argumento de tamanho é a quantidade de blocos; o total em bytes
+    // vem da soma dos iov_len, feita em copy().
+    std::size_t got =
+        copy(event, *desc, desc->is_iovec ? m_max_bytes : event.args[desc->len_arg]);
+    if (got == 0)
+        return;
+    // O buffer precisa ser copiado agora, antes que a syscall o consuma, mas só vai para o
+    // arquivo se o filtro aceitar a chamada.
+    if (defer)
+        m_pending[event.tid].assign(m_buffer.data(), m_buffer.data() + got);
+    else
+        append(event, m_buffer.data(), got);
+}
+
+void PayloadCapture::commit_entry(SyscallEvent &event)
+{
+    auto it = m_pending.find(event.tid);
+    if (it == m_pending.end())
+        return;
+    append(event, it->second.data(), it->second.size());
+    m_pending.erase(it);
+}
+
+void PayloadCapture::discard_entry(pid_t tid)
+{
+    m_pending.erase(tid);
+}
+
+void PayloadCapture::capture_exit(SyscallEvent &event)
+{
+    if (event.nr < 0 || static_cast<std::size_t>(event.nr) >= m_enabled.size() ||
+        !m_enabled[event.nr] || event.ret <= 0)
+        return;
+    const DataBuffer *desc = find_data_buffer(event.nr);
+    if (!captures_at_exit(event, *desc))
+        return;
+    // Em leituras, só os primeiros 'ret' bytes do buffer foram preenchidos pelo kernel; em
+    // escritas sem espera, só eles foram consumidos.
+    std::size_t got = copy(event, *desc, static_cast<unsigned long long>(event.ret));
+    if (got > 0)
+        append(event, m_buffer.data(), got);
+}
+
+std::size_t PayloadCapture::copy(const SyscallEvent &event, const DataBuffer &desc,
+                                 unsigned long long limit)
+{
+    std::size_t want = std::min<unsigned long long>(limit, m_max_bytes);
+    if (want == 0)
+        return 0;
+
+    std::size_t got = 0;
+    unsigned long addr = event.args[desc.buf_arg];
+    if (!desc.is_iovec)
+    {
+        got = ProcessMemory::read(event.tid, addr, m_buffer.data(), want);
+    }
+    else
+    {
+        // Lê o vetor de iovec do processo e o usa diretamente como lista remota da cópia,
+        // cortando os blocos para respeitar o limite.
+        iovec iovs[kMaxIovecs];
+        std::size_t count = std::min<unsigned long long>(event.args[desc.len_arg], kMaxIovecs);
+        count = ProcessMemory::read(event.tid, addr, iovs, count * sizeof(iovec)) / sizeof(iovec);
+        std::size_t total = 0;
+        std::size_t used = 0;
+        while (used < count && total < want)
+        {
+            iovs[used].iov_len = std::min(iovs[used].iov_len, want - total);
+            total += iovs[used].iov_len;
+            ++used;
+        }
+        got = ProcessMemory::readv(event.tid, iovs, used, m_buffer.data(), want);
+    }
+    return got;
+}
+
+void PayloadCapture::append(SyscallEvent &event, const char *data, std::size_t size)
+{
+    m_file.write(data, static_cast<std::streamsize>(size));
+    event.payload_offset = m_offset;
+    event.payload_len = static_cast<std::uint32_t>(size);
+    m_offset += size;
+}
@@ -0,0 +1,193 @@
+#include "ProcMaps.h" // Headers do projeto
+
+#include "spdlog/fmt/fmt.h" // Usado para formatar os endereços
+
+#include <algorithm> // Usado pelo std::upper_bound e pela ordenação dos símbolos
+#include <fstream>   // Usado para ler o /proc/[pid]/maps e os arquivos ELF
+#include <iterator>  // Usado pelo std::prev
+#include <sstream>   // Usado para separar os campos de cada linha
+
+#include <elf.h> // Usado pelos cabeçalhos, segmentos e símbolos de arquivos ELF
+
+std::string ProcMaps::resolve(pid_t pid, std::uint64_t addr)
+{
+    auto it = m_maps.find(pid);
+    const Mapping *mapping = it != m_maps.end() ? find(it->second, addr) : nullptr;
+    if (!mapping)
+    {
+        // O endereço pode ser de uma biblioteca ou de um mapeamento criado depois da última
+        // leitura. Endereços em memória anônima já conhecida não chegam aqui.
+        std::vector<Mapping> &maps = m_maps[pid];
+        maps = load(pid);
+        mapping = find(maps, addr);
+    }
+    if (!mapping || mapping->module.empty())
+        return fmt::format("{:#x}", addr);
+
+    std::uint64_t offset = addr - mapping->start + mapping->base;
+    if (!mapping->path.empty())
+    {
+        // O último símbolo que começa antes do endereço, se o endereço estiver dentro dele.
+        const std::vector<Symbol> &symbols = module(mapping->path).symbols;
+        auto before = [](std::uint64_t value, const Symbol &s) { return value < s.value; };
+        auto sym = std::upper_bound(symbols.begin(), symbols.end(), offset, before);
+        if (sym != symbols.begin() && offset - std::prev(sym)->value < std::prev(sym)->size)
+        {
+            --sym;
+            if (offset == sym->value)
+                return fmt::format("{}!{}", mapping->module, sym->name);
+            return fmt::format("{}!{}+{:#x}", mapping->module, sym->name, offset - sym->value);
+        }
+    }
+    return fmt::format("{}+{:#x}", mapping->module, offset);
+}
+
+void ProcMaps::forget(pid_t pid)
+{
+    m_maps.erase(pid);
+}
+
+const ProcMaps::Mapping *ProcMaps::find(const std::vector<Mapping> &maps, std::uint64_t addr)
+{
+    // Os mapeamentos do /proc/[pid]/maps já vêm ordenados pelo endereço inicial.
+    auto before = [](std::uint64_t value, const Mapping &m) { return value < m.start; };
+    auto it = std::upper_bound(maps.begin(), maps.end(), addr, before);
+    if (it == maps.begin())
+        return nullptr;
+    --it;
+    return addr < it->end ? &*it : nullptr;
+}
+
+std::vector<ProcMaps::Mapping> ProcMaps::load(pid_t pid)
+{
+    std::vector<Mapping> maps;
+    std::ifstream file("/proc/" + std::to_string(pid) + "/maps");
+    std::string line;
+    while (std::getline(file, line))
+    {
+        // Formato: "início-fim permissões deslocamento dispositivo inode caminho".
+        std::istringstream fields(line);
+        std::string range, perms, offset, dev, inode, path;
+        fields >> range >> perms >> offset >> dev >> inode;
+        std::getline(fields >> std::ws, path);
+
+        Mapping mapping;
+        mapping.start = std::stoull(range.substr(0, range.find('-')), nullptr, 16);
+        mapping.end = std::stoull(range.substr(range.find('-') + 1), nullptr, 16);
+        if (path.empty())
+        {
+            // Memória anônima logo depois de um arquivo só é a .bss dele se o último PT_LOAD do
+            // arquivo tem memória além do conteúdo do arquivo e ela chega até este endereço. Senão
+            // é um mapeamento sem nome (ex: a pilha de uma thread) que caiu ao lado do arquivo.
+            mapping.base = 0;
+            if (!maps.empty() && !maps.back().path.empty() && maps.back().end == mapping.start)
+            {
+                const Mapping &previous = maps.back();
+                std::uint64_t base = previous.base + (previous.end - previous.start);
+                const std::vector<Segment> &loads = module(previous.path).loads;
+                if (!loads.empty() && loads.back().mem_size > loads.back().file_size &&
+                    base < ((loads.back().vaddr + loads.back().mem_size + 0xfff) & ~0xfffULL))
+                {
+                    mapping.base = base;
+                    mapping.module = previous.module;
+                    mapping.path = previous.path;
+                }
+            }
+        }
+        else if (path.front() == '/')
+        {
+            // O deslocamento no arquivo vira endereço virtual pelo segmento que o contém.
+            std::uint64_t file_offset = std::stoull(offset, nullptr, 16);
+            mapping.base = file_offset;
+            for (const Segment &segment : module(path).loads)
+            {
+                std::uint64_t page_start = segment.offset & ~static_cast<std::uint64_t>(0xfff);
+                if (file_offset >= page_start && file_offset < segment.offset + segment.file_size)
+                {
+                    mapping.base = file_offset - segment.offset + segment.vaddr;
+                    break;
+                }
+            }
+            mapping.module = path.substr(path.rfind('/') + 1);
+            mapping.path = path;
+        }
+        else
+        {
+            mapping.base = 0; // [heap], [stack], [vdso], etc.
+            mapping.module = path;
+        }
+        maps.push_back(std::move(mapping));
+    }
+    return maps;
+}
+
+const ProcMaps::Module &ProcMaps::module(const std::string &path)
+{
+    auto it = m_modules.find(path);
+    if (it == m_modules.end())
+        it = m_modules.emplace(path, read_elf(path)).first;
+    return it->second;
+}
+
+ProcMaps::Module ProcMaps::read_elf(const std::string &path)
+{
+    Module result;
+    std::ifstream file(path, std::ios::binary);
+    Elf64_Ehdr header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::string(reinterpret_cast<const char *>(header.e_ident), SELFMAG) != ELFMAG ||
+        header.e_ident[EI_CLASS] != ELFCLASS64)
+        return result; // Não é um ELF de 64 bits, ou foi apagado: fica o deslocamento no arquivo.
+
+    auto read_at = [&file](std::uint64_t offset, void *out, std::size_t size) {
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(offset));
+        return static_cast<bool>(file.read(static_cast<char *>(out), size));
+    };
+
+    for (std::size_t i = 0; i < header.e_phnum; ++i)
+    {
+        Elf64_Phdr segment;
+        if (!read_at(header.e_phoff + i * header.e_phentsize, &segment, sizeof(segment)))
+            break;
+        if (segment.p_type == PT_LOAD)
+            result.loads.push_back(
+                {segment.p_offset, segment.p_vaddr, segment.p_filesz, segment.p_memsz});
+    }
+
+    // A .symtab é completa; a .dynsym só tem os símbolos exportados, mas sobrevive ao strip.
+    std::vector<Elf64_Shdr> sections(header.e_shnum);
+    for (std::size_t i = 0; i < sections.size(); ++i)
+    {
+        if (!read_at(header.e_shoff + i * header.e_shentsize, &sections[i], sizeof(Elf64_Shdr)))
+            return result;
+    }
+    const Elf64_Shdr *table = nullptr;
+    for (const Elf64_Shdr &section : sections)
+    {
+        if (section.sh_type == SHT_SYMTAB || (section.sh_type == SHT_DYNSYM && !table))
+            table = &section;
+    }
+    if (!table || table->sh_link >= sections.size() || table->sh_entsize != sizeof(Elf64_Sym))
+        return result;
+
+    const Elf64_Shdr &names = sections[table->sh_link];
+    std::string strings(names.sh_size, '\0');
+    std::vector<Elf64_Sym> symbols(table->sh_size / sizeof(Elf64_Sym));
+    if (!read_at(names.sh_offset, strings.data(), strings.size()) ||
+        !read_at(table->sh_offset, symbols.data(), symbols.size() * sizeof(Elf64_Sym)))
+        return result;
+
+    for (const Elf64_Sym &symbol : symbols)
+    {
+        unsigned type = ELF64_ST_TYPE(symbol.st_info);
+        if ((type != STT_FUNC && type != STT_OBJECT) || symbol.st_shndx == SHN_UNDEF ||
+            symbol.st_size == 0 || symbol.st_name >= strings.size())
+            continue;
+        result.symbols.push_back(
+            {symbol.st_value, symbol.st_size, strings.c_str() + symbol.st_name});
+    }
+    std::sort(result.symbols.begin(), result.symbols.end(),
+              [](const Symbol &a, const Symbol &b) { return a.value < b.value; });
+    return result;
+}
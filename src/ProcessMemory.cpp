@@ -0,0 +1,55 @@
+#include "ProcessMemory.h" // Headers do projeto
+
+#include "spdlog/spdlog.h" // Usado pelo fmt::format
+
+#include <algorithm> // Usado pelo std::min
+#include <cstring>   // Usado pelo memchr
+
+#include <unistd.h> // Usado pelo sysconf para descobrir o tamanho da página
+
+/// @brief Tamanho máximo lido de uma string antes de truncá-la.
+static constexpr std::size_t kMaxStringLength = 256;
+
+std::string ProcessMemory::read_string(pid_t pid, unsigned long addr)
+{
+    // Um endereço de ponteiro nulo é simplesmente retornado como "NULL".
+    if (addr == 0)
+        return "NULL";
+
+    // A string pode terminar perto do fim de uma página mapeada e a página seguinte pode não
+    // existir. Como as cópias parciais do process_vm_readv acontecem na granularidade de cada
+    // iovec, o bloco remoto é dividido na fronteira da página.
+    static const unsigned long page_size = sysconf(_SC_PAGESIZE);
+    unsigned long page_end = (addr / page_size + 1) * page_size;
+    std::size_t first = std::min<std::size_t>(kMaxStringLength, page_end - addr);
+
+    char buf[kMaxStringLength];
+    iovec remote[2] = {{reinterpret_cast<void *>(addr), first},
+                       {reinterpret_cast<void *>(page_end), kMaxStringLength - first}};
+    std::size_t got = readv(pid, remote, first < kMaxStringLength ? 2 : 1, buf, sizeof(buf));
+    if (got == 0)
+        return fmt::format("{:#x}", addr);
+
+    // Retorna a string entre aspas ao encontrar o terminador nulo.
+    const char *end = static_cast<const char *>(std::memchr(buf, '\0', got));
+    if (end)
+        return fmt::format("\"{}\"", std::string(buf, end - buf));
+    // Se a string for muito longa, ela é truncada.
+    return fmt::format("\"{}...\"", std::string(buf, got));
+}
+
+std::size_t ProcessMemory::read(pid_t pid, unsigned long addr, void *buf, std::size_t len)
+{
+    iovec remote{reinterpret_cast<void *>(addr), len};
+    return readv(pid, &remote, 1, buf, len);
+}
+
+std::size_t ProcessMemory::readv(pid_t pid, const iovec *remote, std::size_t count, void *buf,
+                                 std::size_t len)
+{
+    if (len == 0 || count == 0)
+        return 0;
+    iovec local{buf, len};
+    ssize_t got = process_vm_readv(pid, &local, 1, remote, count, 0);
+    return got > 0 ? static_cast<std::size_t>(got) : 0;
+}
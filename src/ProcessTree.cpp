@@ -0,0 +1,301 @@
+#include "ProcessTree.h" // Headers do projeto
+
+#include "spdlog/spdlog.h" // Usado para registrar o relatório
+
+#include <algorithm> // Usado pela ordenação das subárvores e dos comandos
+#include <fstream>   // Usado para ler o /proc/[pid]/stat e o /proc/[pid]/cmdline
+#include <iterator>  // Usado pelo std::istreambuf_iterator
+#include <map>       // Usado pela agregação por comando
+#include <sstream>   // Usado para separar os campos do stat
+
+#include <unistd.h> // Usado pelo sysconf(_SC_CLK_TCK)
+
+/// @brief Tamanho máximo guardado da linha de comando de cada processo.
+static constexpr std::size_t kMaxArgv = 160;
+
+/// @brief Tamanho máximo do caminho crítico no relatório.
+static constexpr std::size_t kMaxPath = 64;
+
+/// @brief Folga mínima entre o fim de um filho e o do pai para o filho entrar no caminho crítico
+/// (a folga também cresce com 5% da duração do pai).
+static constexpr std::uint64_t kPathSlackNs = 10000000;
+
+/**
+ * @brief Lê os campos do /proc/.../stat que vêm depois do nome do processo.
+ * @param path O caminho do arquivo stat.
+ * @return Os campos a partir do estado (o campo 3 do proc(5) fica no índice 0), ou vazio se o
+ * processo já não existe.
+ */
+static std::vector<std::string> read_stat(const std::string &path)
+{
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    // O nome entre parênteses pode conter espaços e parênteses; o último ')' o encerra.
+    const auto close = line.rfind(')');
+    std::vector<std::string> fields;
+    if (close == std::string::npos)
+        return fields;
+    std::istringstream rest(line.substr(close + 1));
+    std::string field;
+    while (rest >> field)
+        fields.push_back(field);
+    return fields;
+}
+
+/**
+ * @brief Lê a linha de comando de um processo, com os argumentos separados por espaço.
+ * @param pid O PID do processo.
+ * @return A linha de comando truncada em kMaxArgv caracteres.
+ */
+static std::string read_cmdline(pid_t pid)
+{
+    std::ifstream file("/proc/" + std::to_string(pid) + "/cmdline", std::ios::binary);
+    std::string argv((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    while (!argv.empty() && argv.back() == '\0')
+        argv.pop_back();
+    std::replace(argv.begin(), argv.end(), '\0', ' ');
+    if (argv.size() > kMaxArgv)
+        argv = argv.substr(0, kMaxArgv - 3) + "...";
+    return argv;
+}
+
+/**
+ * @brief Retorna o nome do programa de uma linha de comando, sem o diretório.
+ * @param argv A linha de comando.
+ * @return O primeiro argumento sem o diretório, ou "?" se a linha está vazia.
+ */
+static std::string command_name(const std::string &argv)
+{
+    std::string first = argv.substr(0, argv.find(' '));
+    first = first.substr(first.rfind('/') + 1);
+    return first.empty() ? "?" : first;
+}
+
+ProcessTreeProfiler::ProcessTreeProfiler(std::size_t top)
+    : m_top(top), m_ticks_per_second(sysconf(_SC_CLK_TCK))
+{
+}
+
+std::uint32_t ProcessTreeProfiler::node(pid_t pid, std::uint64_t ts_ns)
+{
+    const auto it = m_live.find(pid);
+    if (it != m_live.end())
+        return it->second;
+
+    // Um processo que já existia (anexado, ou o filho inicial antes do primeiro exec): o pai e o
+    // início vêm do /proc. O starttime conta desde o boot, o mesmo relógio do steady_clock se o
+    // sistema não foi suspenso; o instante do evento é o limite.
+    Node created;
+    created.pid = pid;
+    created.start_ns = ts_ns;
+    const std::vector<std::string> fields = read_stat("/proc/" + std::to_string(pid) + "/stat");
+    if (fields.size() > 19)
+    {
+        const auto parent = m_live.find(std::stoi(fields[1]));
+        if (parent != m_live.end())
+            created.parent = parent->second;
+        const std::uint64_t start_ticks = std::stoull(fields[19]);
+        const auto ticks = static_cast<std::uint64_t>(m_ticks_per_second);
+        created.start_ns = std::min(ts_ns, start_ticks * 1000000000 / ticks);
+    }
+    created.argv = read_cmdline(pid);
+
+    const auto index = static_cast<std::uint32_t>(m_nodes.size());
+    m_nodes.push_back(std::move(created));
+    m_live[pid] = index;
+    return index;
+}
+
+void ProcessTreeProfiler::on_process_event(const ProcessEvent &event)
+{
+    if (m_first_ns == 0)
+        m_first_ns = event.ts_ns;
+    m_last_ns = std::max(m_last_ns, event.ts_ns);
+
+    switch (event.type)
+    {
+    case ProcessEventType::Fork:
+    case ProcessEventType::Vfork:
+    case ProcessEventType::Clone:
+    {
+        const std::uint32_t parent = node(event.pid, event.ts_ns);
+        if (event.child_pid == event.pid)
+        {
+            ++m_nodes[parent].threads;
+            break;
+        }
+        // Até o exec, o filho roda o mesmo programa do pai.
+        Node child;
+        child.pid = event.child_pid;
+        child.parent = parent;
+        child.start_ns = event.ts_ns;
+        child.argv = m_nodes[parent].argv;
+        m_live[event.child_pid] = static_cast<std::uint32_t>(m_nodes.size());
+        m_nodes.push_back(std::move(child));
+        break;
+    }
+    case ProcessEventType::Exec:
+    {
+        Node &execed = m_nodes[node(event.pid, event.ts_ns)];
+        execed.exec_ns = event.ts_ns;
+        ++execed.execs;
+        execed.argv = read_cmdline(event.pid);
+        break;
+    }
+    case ProcessEventType::Exiting:
+    {
+        // utime e stime são os campos 14 e 15 do stat da thread.
+        Node &exiting = m_nodes[node(event.pid, event.ts_ns)];
+        const std::vector<std::string> fields = read_stat(
+            "/proc/" + std::to_string(event.pid) + "/task/" + std::to_string(event.tid) + "/stat");
+        if (fields.size() > 12)
+        {
+            exiting.utime += std::stoull(fields[11]);
+            exiting.stime += std::stoull(fields[12]);
+        }
+        break;
+    }
+    case ProcessEventType::Exit:
+    {
+        // O processo termina com a thread principal; o PID pode ser reutilizado depois disso.
+        const auto it = m_live.find(event.pid);
+        if (event.tid != event.pid || it == m_live.end())
+            break;
+        m_nodes[it->second].end_ns = event.ts_ns;
+        m_nodes[it->second].status = event.status;
+        m_live.erase(it);
+        break;
+    }
+    }
+}
+
+void ProcessTreeProfiler::on_finish()
+{
+    const std::size_t count = m_nodes.size();
+    if (count == 0)
+        return;
+    const double ticks = static_cast<double>(m_ticks_per_second);
+    auto seconds = [](std::uint64_t ns) { return ns / 1e9; };
+
+    // Os pais sempre vêm antes dos filhos no vetor, então uma passada de trás para frente acumula
+    // as subárvores. Processos que não terminaram contam até o último evento.
+    std::vector<std::uint64_t> end(count);
+    std::vector<std::uint64_t> subtree_end(count);
+    std::vector<std::uint64_t> subtree_cpu(count);
+    std::vector<std::uint32_t> subtree_size(count, 1);
+    std::vector<std::uint32_t> first_child(count, kNone);
+    std::vector<std::uint32_t> next_sibling(count, kNone);
+    std::uint64_t utime = 0, stime = 0, threads = 0, execs = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const Node &n = m_nodes[i];
+        end[i] = n.end_ns ? n.end_ns : m_last_ns;
+        subtree_end[i] = end[i];
+        subtree_cpu[i] = n.utime + n.stime;
+        utime += n.utime;
+        stime += n.stime;
+        threads += n.threads + 1;
+        execs += n.execs;
+    }
+    for (std::size_t i = count; i-- > 0;)
+    {
+        const std::uint32_t parent = m_nodes[i].parent;
+        if (parent == kNone)
+            continue;
+        subtree_end[parent] = std::max(subtree_end[parent], subtree_end[i]);
+        subtree_cpu[parent] += subtree_cpu[i];
+        subtree_size[parent] += subtree_size[i];
+        next_sibling[i] = first_child[parent];
+        first_child[parent] = static_cast<std::uint32_t>(i);
+    }
+
+    spdlog::info("PROCESS_TREE {} processo(s), {} thread(s), {} exec(s) em {:.3f}s; CPU {:.3f}s "
+                 "(usuário {:.3f}s, sistema {:.3f}s)",
+                 count, threads, execs, seconds(m_last_ns - m_first_ns), (utime + stime) / ticks,
+                 utime / ticks, stime / ticks);
+
+    // O caminho crítico começa na raiz que terminou por último e segue, a cada nível, o filho
+    // cuja subárvore terminou por último, se ela terminou perto do fim do pai: é por ele que o pai
+    // estava esperando. Senão, o próprio pai é o fim do caminho.
+    std::uint32_t current = kNone;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (m_nodes[i].parent == kNone &&
+            (current == kNone || subtree_end[i] > subtree_end[current]))
+            current = static_cast<std::uint32_t>(i);
+    }
+    for (std::size_t depth = 0; current != kNone && depth < kMaxPath; ++depth)
+    {
+        const Node &n = m_nodes[current];
+        const std::uint64_t start = std::max(n.start_ns, m_first_ns);
+        spdlog::info("CRITICAL_PATH #{} [PID:{}] +{:.3f}s até +{:.3f}s wall={:.3f}s "
+                     "cpu={:.3f}s (subárvore {:.3f}s em {} processo(s)) {}",
+                     depth, n.pid, seconds(start - m_first_ns), seconds(end[current] - m_first_ns),
+                     seconds(end[current] - start), (n.utime + n.stime) / ticks,
+                     subtree_cpu[current] / ticks, subtree_size[current], n.argv);
+        std::uint32_t next = kNone;
+        for (std::uint32_t c = first_child[current]; c != kNone; c = next_sibling[c])
+        {
+            if (next == kNone || subtree_end[c] > subtree_end[next])
+                next = c;
+        }
+        const std::uint64_t slack = std::max(kPathSlackNs, (end[current] - start) / 20);
+        if (next != kNone && subtree_end[next] + slack < end[current])
+            next = kNone;
+        current = next;
+    }
+
+    // As subárvores mais lentas, do início do processo ao término do último descendente.
+    std::vector<std::uint32_t> order(count);
+    for (std::size_t i = 0; i < count; ++i)
+        order[i] = static_cast<std::uint32_t>(i);
+    auto wall = [&](std::uint32_t i) {
+        return subtree_end[i] - std::max(m_nodes[i].start_ns, m_first_ns);
+    };
+    const std::size_t shown = std::min(m_top, count);
+    std::partial_sort(order.begin(), order.begin() + shown, order.end(),
+                      [&](std::uint32_t a, std::uint32_t b) { return wall(a) > wall(b); });
+    for (std::size_t i = 0; i < shown; ++i)
+    {
+        const std::uint32_t index = order[i];
+        const Node &n = m_nodes[index];
+        const std::string parent =
+            n.parent == kNone ? "raiz" : fmt::format("pai {}", m_nodes[n.parent].pid);
+        spdlog::info("PROCESS_SUBTREE #{} [PID:{}] wall={:.3f}s cpu={:.3f}s em {} processo(s) "
+                     "({}) {}",
+                     i + 1, n.pid, seconds(wall(index)), subtree_cpu[index] / ticks,
+                     subtree_size[index], parent, n.argv);
+    }
+
+    // Os programas que mais consumiram CPU, somando todas as execuções.
+    struct Command
+    {
+        std::size_t count = 0;
+        std::uint64_t cpu = 0;
+        std::uint64_t wall_ns = 0;
+        std::uint64_t max_wall_ns = 0;
+    };
+    std::map<std::string, Command> commands;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const Node &n = m_nodes[i];
+        Command &command = commands[command_name(n.argv)];
+        const std::uint64_t own_wall = end[i] - std::max(n.start_ns, m_first_ns);
+        ++command.count;
+        command.cpu += n.utime + n.stime;
+        command.wall_ns += own_wall;
+        command.max_wall_ns = std::max(command.max_wall_ns, own_wall);
+    }
+    std::vector<std::pair<std::string, Command>> by_cpu(commands.begin(), commands.end());
+    std::sort(by_cpu.begin(), by_cpu.end(),
+              [](const auto &a, const auto &b) { return a.second.cpu > b.second.cpu; });
+    for (std::size_t i = 0; i < std::min(m_top, by_cpu.size()); ++i)
+    {
+        const auto &[name, command] = by_cpu[i];
+        spdlog::info("PROCESS_COMMAND #{} {} cpu={:.3f}s em {} processo(s); wall total={:.3f}s "
+                     "(máx {:.3f}s)",
+                     i + 1, name, command.cpu / ticks, command.count, seconds(command.wall_ns),
+                     seconds(command.max_wall_ns));
+    }
+}
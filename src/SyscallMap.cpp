@@ -14,7 +14,7 @@ const std::map<long, SyscallInfo> g_syscall_map = {
     { 6, { "lstat", 2, { "const char __user *", "struct stat __user *" } } },
     { 7, { "poll", 3, { "struct pollfd __user *", "unsigned int", "int" } } },
     { 8, { "lseek", 3, { "unsigned int", "off_t", "unsigned int" } } },
-    { 9, { "mmap", 6, {  } } },
+    { 9, { "mmap", 6, { "unsigned long", "unsigned long", "unsigned long", "unsigned long", "unsigned long", "unsigned long" } } },
     { 10, { "mprotect", 3, { "unsigned long", "size_t", "unsigned long" } } },
     { 11, { "munmap", 2, { "unsigned long", "size_t" } } },
     { 12, { "brk", 1, { "unsigned long" } } },
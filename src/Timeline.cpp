@@ -0,0 +1,433 @@
+#include "Timeline.h" // Headers do projeto
+#include "Syscall.h"  // Headers do projeto
+
+#include "spdlog/spdlog.h" // Usado para registrar erros e formatar o JSON
+
+#include <fstream> // Usado pelo arquivo de saída e para ler /proc/[pid]/comm
+
+/**
+ * @brief Lê o nome curto (comm) de uma thread ou processo.
+ * @param tid O TID ou PID.
+ * @return O nome, ou o próprio número se o processo já não existir.
+ */
+static std::string read_comm(pid_t tid)
+{
+    std::ifstream comm("/proc/" + std::to_string(tid) + "/comm");
+    std::string name;
+    if (!std::getline(comm, name) || name.empty())
+        return std::to_string(tid);
+    return name;
+}
+
+/**
+ * @brief Troca bytes não imprimíveis por "\xNN", já que strings lidas do tracee podem conter
+ * qualquer conteúdo e os dois formatos de saída esperam texto.
+ */
+static std::string printable(const std::string &in)
+{
+    std::string out;
+    out.reserve(in.size());
+    for (unsigned char c : in)
+    {
+        if (c >= 0x20 && c < 0x7f)
+            out += static_cast<char>(c);
+        else
+            out += fmt::format("\\x{:02x}", c);
+    }
+    return out;
+}
+
+/**
+ * @brief Escapa uma string (já imprimível) para ser usada dentro de aspas no JSON.
+ */
+static std::string json_escape(const std::string &in)
+{
+    std::string out;
+    out.reserve(in.size());
+    for (char c : printable(in))
+    {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+namespace
+{
+/**
+ * @class ChromeJsonTimeline
+ * @brief Escreve a linha do tempo no formato JSON de eventos do Chrome (chrome://tracing).
+ * Cada evento é escrito em uma linha, assim o arquivo é gerado em streaming.
+ */
+class ChromeJsonTimeline : public TimelineExporter
+{
+  public:
+    explicit ChromeJsonTimeline(std::ofstream file) : m_file(std::move(file))
+    {
+        m_file << "[\n";
+    }
+
+  protected:
+    void write_process(pid_t pid, const std::string &name) override
+    {
+        write_event(fmt::format(R"({{"ph":"M","name":"process_name","pid":{},"args":{{"name":"{}"}}}})",
+                                pid, json_escape(name)));
+    }
+
+    void write_thread(pid_t pid, pid_t tid, const std::string &name) override
+    {
+        write_event(fmt::format(
+            R"({{"ph":"M","name":"thread_name","pid":{},"tid":{},"args":{{"name":"{}"}}}})", pid,
+            tid, json_escape(name)));
+    }
+
+    void write_slice(pid_t pid, pid_t tid, const std::string &name, std::uint64_t begin_ns,
+                     std::uint64_t end_ns, const std::string &args, long long ret) override
+    {
+        write_event(fmt::format(
+            R"({{"ph":"X","cat":"syscall","name":"{}","pid":{},"tid":{},"ts":{:.3f},"dur":{:.3f},"args":{{"args":"{}","ret":{}}}}})",
+            name, pid, tid, begin_ns / 1e3, (end_ns - begin_ns) / 1e3, json_escape(args), ret));
+    }
+
+    void write_instant(pid_t pid, pid_t tid, const std::string &name, std::uint64_t ts_ns,
+                       std::uint64_t flow_id, FlowPhase phase) override
+    {
+        write_event(fmt::format(
+            R"({{"ph":"i","s":"t","cat":"process","name":"{}","pid":{},"tid":{},"ts":{:.3f}}})",
+            json_escape(name), pid, tid, ts_ns / 1e3));
+        if (flow_id == 0)
+            return;
+        // As setas de fluxo do Chrome são eventos separados, ligados à fatia que os envolve.
+        const char *ph = phase == FlowPhase::Begin ? "s" : phase == FlowPhase::Step ? "t" : "f";
+        write_event(fmt::format(
+            R"({{"ph":"{}","bp":"e","cat":"process","name":"spawn","id":{},"pid":{},"tid":{},"ts":{:.3f}}})",
+            ph, flow_id, pid, tid, ts_ns / 1e3));
+    }
+
+    void close() override
+    {
+        m_file << "\n]\n";
+        m_file.close();
+    }
+
+  private:
+    void write_event(const std::string &json)
+    {
+        if (!m_first)
+            m_file << ",\n";
+        m_first = false;
+        m_file << json;
+    }
+
+    std::ofstream m_file;
+    bool m_first = true;
+};
+
+/**
+ * @class ProtoMessage
+ * @brief Codificador mínimo de mensagens protobuf, suficiente para o formato de trace do
+ * Perfetto.
+ */
+class ProtoMessage
+{
+  public:
+    void add_varint(std::uint32_t field, std::uint64_t value)
+    {
+        tag(field, 0);
+        varint(value);
+    }
+
+    void add_fixed64(std::uint32_t field, std::uint64_t value)
+    {
+        tag(field, 1);
+        for (int i = 0; i < 8; ++i)
+            m_data += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+
+    void add_bytes(std::uint32_t field, const std::string &value)
+    {
+        tag(field, 2);
+        varint(value.size());
+        m_data += value;
+    }
+
+    void add_message(std::uint32_t field, const ProtoMessage &message)
+    {
+        add_bytes(field, message.m_data);
+    }
+
+    const std::string &data() const
+    {
+        return m_data;
+    }
+
+  private:
+    void tag(std::uint32_t field, std::uint32_t wire_type)
+    {
+        varint((static_cast<std::uint64_t>(field) << 3) | wire_type);
+    }
+
+    void varint(std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            m_data += static_cast<char>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        m_data += static_cast<char>(value);
+    }
+
+    std::string m_data;
+};
+
+/**
+ * @class PerfettoTimeline
+ * @brief Escreve a linha do tempo no formato protobuf do Perfetto (perfetto.protos.Trace).
+ *
+ * O arquivo é uma sequência de campos 'packet' (1) da mensagem Trace, então cada TracePacket é
+ * anexado assim que é gerado.
+ */
+class PerfettoTimeline : public TimelineExporter
+{
+  public:
+    explicit PerfettoTimeline(std::ofstream file) : m_file(std::move(file))
+    {
+    }
+
+  protected:
+    // Números dos campos usados de perfetto/trace/trace_packet.proto e track_event/*.proto.
+    enum : std::uint32_t
+    {
+        kTracePacket = 1,
+        kPacketTimestamp = 8,
+        kPacketSequenceId = 10,
+        kPacketTrackEvent = 11,
+        kPacketSequenceFlags = 13,
+        kPacketTrackDescriptor = 60,
+        kTrackUuid = 1,
+        kTrackProcess = 3,
+        kTrackThread = 4,
+        kTrackParentUuid = 5,
+        kProcessPid = 1,
+        kProcessName = 6,
+        kThreadPid = 1,
+        kThreadTid = 2,
+        kThreadName = 5,
+        kEventDebugAnnotation = 4,
+        kEventType = 9,
+        kEventTrackUuid = 11,
+        kEventName = 23,
+        kEventFlowIds = 47,
+        kEventTerminatingFlowIds = 48,
+        kAnnotationIntValue = 4,
+        kAnnotationStringValue = 6,
+        kAnnotationName = 10,
+    };
+
+    // Valores de TrackEvent.Type.
+    enum : std::uint64_t
+    {
+        kSliceBegin = 1,
+        kSliceEnd = 2,
+        kInstant = 3,
+    };
+
+    static std::uint64_t process_uuid(pid_t pid)
+    {
+        return (static_cast<std::uint64_t>(pid) << 1) | 1;
+    }
+
+    static std::uint64_t thread_uuid(pid_t tid)
+    {
+        return static_cast<std::uint64_t>(tid) << 1;
+    }
+
+    void write_process(pid_t pid, const std::string &name) override
+    {
+        ProtoMessage process;
+        process.add_varint(kProcessPid, pid);
+        process.add_bytes(kProcessName, printable(name));
+        ProtoMessage track;
+        track.add_varint(kTrackUuid, process_uuid(pid));
+        track.add_message(kTrackProcess, process);
+        ProtoMessage packet;
+        packet.add_message(kPacketTrackDescriptor, track);
+        write_packet(packet);
+    }
+
+    void write_thread(pid_t pid, pid_t tid, const std::string &name) override
+    {
+        ProtoMessage thread;
+        thread.add_varint(kThreadPid, pid);
+        thread.add_varint(kThreadTid, tid);
+        thread.add_bytes(kThreadName, printable(name));
+        ProtoMessage track;
+        track.add_varint(kTrackUuid, thread_uuid(tid));
+        track.add_varint(kTrackParentUuid, process_uuid(pid));
+        track.add_message(kTrackThread, thread);
+        ProtoMessage packet;
+        packet.add_message(kPacketTrackDescriptor, track);
+        write_packet(packet);
+    }
+
+    void write_slice(pid_t, pid_t tid, const std::string &name, std::uint64_t begin_ns,
+                     std::uint64_t end_ns, const std::string &args, long long ret) override
+    {
+        ProtoMessage args_annotation;
+        args_annotation.add_bytes(kAnnotationName, "args");
+        args_annotation.add_bytes(kAnnotationStringValue, printable(args));
+        ProtoMessage ret_annotation;
+        ret_annotation.add_bytes(kAnnotationName, "ret");
+        ret_annotation.add_varint(kAnnotationIntValue, static_cast<std::uint64_t>(ret));
+
+        ProtoMessage begin;
+        begin.add_varint(kEventType, kSliceBegin);
+        begin.add_varint(kEventTrackUuid, thread_uuid(tid));
+        begin.add_bytes(kEventName, name);
+        begin.add_message(kEventDebugAnnotation, args_annotation);
+        begin.add_message(kEventDebugAnnotation, ret_annotation);
+        write_event(begin_ns, begin);
+
+        ProtoMessage end;
+        end.add_varint(kEventType, kSliceEnd);
+        end.add_varint(kEventTrackUuid, thread_uuid(tid));
+        write_event(end_ns, end);
+    }
+
+    void write_instant(pid_t, pid_t tid, const std::string &name, std::uint64_t ts_ns,
+                       std::uint64_t flow_id, FlowPhase phase) override
+    {
+        ProtoMessage event;
+        event.add_varint(kEventType, kInstant);
+        event.add_varint(kEventTrackUuid, thread_uuid(tid));
+        event.add_bytes(kEventName, printable(name));
+        if (flow_id != 0)
+            event.add_fixed64(phase == FlowPhase::End ? kEventTerminatingFlowIds : kEventFlowIds,
+                              flow_id);
+        write_event(ts_ns, event);
+    }
+
+    void close() override
+    {
+        m_file.close();
+    }
+
+  private:
+    void write_event(std::uint64_t ts_ns, const ProtoMessage &event)
+    {
+        ProtoMessage packet;
+        packet.add_varint(kPacketTimestamp, ts_ns);
+        packet.add_message(kPacketTrackEvent, event);
+        write_packet(packet);
+    }
+
+    void write_packet(ProtoMessage &packet)
+    {
+        // Todos os pacotes pertencem à mesma sequência. O primeiro indica que o estado
+        // incremental da sequência começa limpo.
+        packet.add_varint(kPacketSequenceId, 1);
+        if (m_first)
+        {
+            packet.add_varint(kPacketSequenceFlags, 1); // SEQ_INCREMENTAL_STATE_CLEARED
+            m_first = false;
+        }
+        ProtoMessage trace;
+        trace.add_message(kTracePacket, packet);
+        m_file.write(trace.data().data(), static_cast<std::streamsize>(trace.data().size()));
+    }
+
+    std::ofstream m_file;
+    bool m_first = true;
+};
+} // namespace
+
+std::unique_ptr<TimelineExporter> TimelineExporter::create(const std::string &path)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        spdlog::error("Não foi possível abrir o arquivo de linha do tempo {}", path);
+        return nullptr;
+    }
+    spdlog::info("Exportando a linha do tempo para {}", path);
+    const std::string json_ext = ".json";
+    if (path.size() >= json_ext.size() &&
+        path.compare(path.size() - json_ext.size(), json_ext.size(), json_ext) == 0)
+        return std::make_unique<ChromeJsonTimeline>(std::move(file));
+    return std::make_unique<PerfettoTimeline>(std::move(file));
+}
+
+void TimelineExporter::ensure_track(pid_t pid, pid_t tid)
+{
+    if (m_known_processes.insert(pid).second)
+        write_process(pid, read_comm(pid));
+    if (m_known_threads.insert(tid).second)
+        write_thread(pid, tid, read_comm(tid));
+}
+
+void TimelineExporter::on_syscall_exit(const SyscallEvent &event)
+{
+    ensure_track(event.pid, event.tid);
+    const auto info = Syscall::get_syscall_info(event.nr);
+    write_slice(event.pid, event.tid, info ? info->name : std::to_string(event.nr),
+                event.entry_ns, event.exit_ns, event.args_str, event.ret);
+}
+
+void TimelineExporter::on_process_event(const ProcessEvent &event)
+{
+    switch (event.type)
+    {
+    case ProcessEventType::Fork:
+    case ProcessEventType::Vfork:
+    case ProcessEventType::Clone:
+    {
+        // A seta parte do evento no pai e passa pelo início do filho.
+        ensure_track(event.pid, event.tid);
+        ensure_track(event.child_pid, event.child_tid);
+        std::uint64_t flow = m_next_flow_id++;
+        const char *name = event.type == ProcessEventType::Fork    ? "fork"
+                           : event.type == ProcessEventType::Vfork ? "vfork"
+                                                                   : "clone";
+        write_instant(event.pid, event.tid, fmt::format("{} {}", name, event.child_tid),
+                      event.ts_ns, flow, FlowPhase::Begin);
+        write_instant(event.child_pid, event.child_tid, "start", event.ts_ns, flow,
+                      FlowPhase::Step);
+        if (event.child_pid != event.pid)
+            m_open_flows[event.child_pid] = flow;
+        break;
+    }
+    case ProcessEventType::Exec:
+    {
+        // O exec troca o nome do processo e encerra a seta que veio do fork.
+        ensure_track(event.pid, event.tid);
+        std::string name = read_comm(event.pid);
+        write_process(event.pid, name);
+        write_thread(event.pid, event.tid, name);
+        std::uint64_t flow = 0;
+        const auto it = m_open_flows.find(event.pid);
+        if (it != m_open_flows.end())
+        {
+            flow = it->second;
+            m_open_flows.erase(it);
+        }
+        write_instant(event.pid, event.tid, "exec " + name, event.ts_ns, flow, FlowPhase::End);
+        break;
+    }
+    case ProcessEventType::Exit:
+        m_known_threads.erase(event.tid);
+        if (event.tid == event.pid)
+        {
+            m_known_processes.erase(event.pid);
+            m_open_flows.erase(event.pid);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void TimelineExporter::on_finish()
+{
+    close();
+}
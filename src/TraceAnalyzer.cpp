@@ -0,0 +1,315 @@
+#include "TraceAnalyzer.h" // Headers do projeto
+#include "Syscall.h"       // Headers do projeto
+
+#include "spdlog/fmt/fmt.h" // Usado para formatar as tabelas do relatório
+
+#include <algorithm> // Usado pelo std::sort e std::min
+#include <atomic>    // Usado pelo índice do próximo bloco
+#include <cerrno>    // Usado pelo errno das chamadas de arquivo
+#include <cstring>   // Usado pelo memcmp, strerror e strerrorname_np
+#include <thread>    // Usado pelas threads de trabalho
+
+#include <fcntl.h>    // Usado pelo open
+#include <sys/mman.h> // Usado pelo mmap e madvise
+#include <sys/stat.h> // Usado pelo fstat
+#include <unistd.h>   // Usado pelo close
+
+/// @brief Registros por bloco (2,5 MiB). Blocos menores que o total de cada thread deixam a fila
+/// equilibrar o trabalho quando algumas threads ficam mais lentas (ex: falhas de página).
+static constexpr std::size_t kChunkRecords = 65536;
+
+/// @brief Maior número de syscall aceito; registros acima disso são contados só no total.
+static constexpr std::int32_t kMaxSyscall = 4096;
+
+std::size_t LatencyHistogram::bucket_of(std::uint64_t ns)
+{
+    if (ns < kSubBuckets)
+        return ns;
+    // A posição do bit mais alto escolhe a potência de dois, e os kSubBits bits seguintes
+    // escolhem o balde dentro dela.
+    unsigned msb = 63 - __builtin_clzll(ns);
+    std::size_t sub = (ns >> (msb - kSubBits)) & (kSubBuckets - 1);
+    return (msb - kSubBits + 1) * kSubBuckets + sub;
+}
+
+std::uint64_t LatencyHistogram::bucket_upper(std::size_t bucket)
+{
+    if (bucket < kSubBuckets)
+        return bucket;
+    unsigned shift = bucket / kSubBuckets - 1;
+    std::uint64_t sub = bucket % kSubBuckets;
+    return ((kSubBuckets + sub) << shift) + ((std::uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::add(std::uint64_t ns)
+{
+    if (m_buckets.empty())
+        m_buckets.resize(kBucketCount);
+    ++m_buckets[bucket_of(ns)];
+    ++m_count;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    if (other.m_buckets.empty())
+        return;
+    if (m_buckets.empty())
+        m_buckets.resize(kBucketCount);
+    for (std::size_t i = 0; i < kBucketCount; ++i)
+        m_buckets[i] += other.m_buckets[i];
+    m_count += other.m_count;
+}
+
+std::uint64_t LatencyHistogram::percentile(double quantile) const
+{
+    if (m_count == 0)
+        return 0;
+    auto rank = static_cast<std::uint64_t>(quantile * static_cast<double>(m_count) + 0.5);
+    rank = std::max<std::uint64_t>(rank, 1);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i)
+    {
+        seen += m_buckets[i];
+        if (seen >= rank)
+            return bucket_upper(i);
+    }
+    return bucket_upper(kBucketCount - 1);
+}
+
+void TraceStats::add(const TraceRecord &record)
+{
+    ++records;
+    first_ns = std::min(first_ns, record.entry_ns);
+    last_ns = std::max(last_ns, record.exit_ns);
+
+    std::uint64_t duration =
+        record.exit_ns > record.entry_ns ? record.exit_ns - record.entry_ns : 0;
+    bool failed = record.ret < 0 && record.ret >= -4095; // Faixa de errno do kernel.
+
+    ProcessStats &process = processes[record.pid];
+    ++process.count;
+    process.errors += failed;
+    process.total_ns += duration;
+
+    if (record.nr < 0 || record.nr >= kMaxSyscall)
+        return;
+    if (static_cast<std::size_t>(record.nr) >= syscalls.size())
+        syscalls.resize(record.nr + 1);
+    SyscallStats &syscall = syscalls[record.nr];
+    ++syscall.count;
+    syscall.total_ns += duration;
+    syscall.max_ns = std::max(syscall.max_ns, duration);
+    syscall.latency.add(duration);
+    if (failed)
+    {
+        ++syscall.errors;
+        ++syscall.errnos[static_cast<int>(-record.ret)];
+    }
+}
+
+void TraceStats::merge(const TraceStats &other)
+{
+    records += other.records;
+    first_ns = std::min(first_ns, other.first_ns);
+    last_ns = std::max(last_ns, other.last_ns);
+
+    if (other.syscalls.size() > syscalls.size())
+        syscalls.resize(other.syscalls.size());
+    for (std::size_t nr = 0; nr < other.syscalls.size(); ++nr)
+    {
+        const SyscallStats &from = other.syscalls[nr];
+        if (from.count == 0)
+            continue;
+        SyscallStats &to = syscalls[nr];
+        to.count += from.count;
+        to.errors += from.errors;
+        to.total_ns += from.total_ns;
+        to.max_ns = std::max(to.max_ns, from.max_ns);
+        to.latency.merge(from.latency);
+        for (const auto &[err, count] : from.errnos)
+            to.errnos[err] += count;
+    }
+
+    for (const auto &[pid, from] : other.processes)
+    {
+        ProcessStats &to = processes[pid];
+        to.count += from.count;
+        to.errors += from.errors;
+        to.total_ns += from.total_ns;
+    }
+}
+
+bool TraceAnalyzer::analyze(const std::string &path, unsigned threads, TraceStats &result,
+                            std::string &error)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st{};
+    if (fd < 0 || fstat(fd, &st) < 0)
+    {
+        error = path + ": " + strerror(errno);
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+    auto size = static_cast<std::size_t>(st.st_size);
+    if (size < sizeof(TraceFileHeader))
+    {
+        close(fd);
+        error = path + ": not a TracerC recording";
+        return false;
+    }
+    void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+
+    const auto *bytes = static_cast<const unsigned char *>(map);
+    TraceFileHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (std::memcmp(header.magic, TraceRecordFormat::kMagic, sizeof(header.magic)) != 0 ||
+        header.version != TraceRecordFormat::kVersion || header.record_size < sizeof(TraceRecord))
+    {
+        munmap(map, size);
+        error = path + ": not a TracerC recording (or an unsupported version)";
+        return false;
+    }
+
+    // Um registro incompleto no final (gravação interrompida) é ignorado.
+    const unsigned char *records = bytes + sizeof(header);
+    const std::size_t stride = header.record_size;
+    const std::size_t total = (size - sizeof(header)) / stride;
+    const std::size_t chunks = (total + kChunkRecords - 1) / kChunkRecords;
+    threads =
+        static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(threads, chunks)));
+
+    // Etapa "map": cada thread acumula os blocos que pegar no seu próprio resultado parcial.
+    std::vector<TraceStats> partials(threads);
+    std::atomic<std::size_t> next_chunk{0};
+    auto worker = [&](unsigned index)
+    {
+        TraceStats local;
+        for (std::size_t chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+             chunk < chunks; chunk = next_chunk.fetch_add(1, std::memory_order_relaxed))
+        {
+            std::size_t begin = chunk * kChunkRecords;
+            std::size_t end = std::min(total, begin + kChunkRecords);
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                TraceRecord record;
+                std::memcpy(&record, records + i * stride, sizeof(record));
+                local.add(record);
+            }
+        }
+        partials[index] = std::move(local);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i)
+        pool.emplace_back(worker, i);
+    worker(0);
+    for (auto &thread : pool)
+        thread.join();
+    munmap(map, size);
+
+    // Etapa "reduce": os parciais são pequenos (um histograma por syscall vista), então a junção
+    // sequencial é desprezível perto da leitura.
+    result = std::move(partials[0]);
+    for (unsigned i = 1; i < threads; ++i)
+        result.merge(partials[i]);
+    return true;
+}
+
+/**
+ * @brief Retorna o nome simbólico de um errno (ex: "ENOENT"), ou o número se não houver.
+ */
+static std::string errno_name(int err)
+{
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 32)
+    if (const char *name = strerrorname_np(err))
+        return name;
+#endif
+    return std::to_string(err);
+}
+
+/**
+ * @brief Retorna o nome de uma syscall, ou "syscall_<nr>" se ela não estiver no mapa.
+ */
+static std::string syscall_name(long nr)
+{
+    const Syscall::SyscallInfo *info = Syscall::get_syscall_info(nr);
+    return info ? info->name : "syscall_" + std::to_string(nr);
+}
+
+void TraceAnalyzer::print_report(const TraceStats &stats, std::size_t top, std::ostream &out)
+{
+    double span_s = stats.last_ns > stats.first_ns ? (stats.last_ns - stats.first_ns) / 1e9 : 0;
+    out << fmt::format("{} syscalls from {} processes over {:.3f}s\n\n", stats.records,
+                       stats.processes.size(), span_s);
+
+    // Syscalls, da que mais consumiu tempo para a que menos consumiu.
+    std::vector<long> order;
+    for (std::size_t nr = 0; nr < stats.syscalls.size(); ++nr)
+        if (stats.syscalls[nr].count > 0)
+            order.push_back(static_cast<long>(nr));
+    std::stable_sort(order.begin(), order.end(), [&](long a, long b)
+                     { return stats.syscalls[a].total_ns > stats.syscalls[b].total_ns; });
+
+    out << fmt::format("{:<20} {:>10} {:>8} {:>12} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10}\n",
+                       "syscall", "calls", "errors", "total(ms)", "avg(us)", "p50(us)", "p90(us)",
+                       "p99(us)", "p99.9(us)", "max(us)");
+    for (long nr : order)
+    {
+        const SyscallStats &s = stats.syscalls[nr];
+        // O limite do balde pode passar do máximo observado; o máximo é exato.
+        auto us = [&](double quantile)
+        { return std::min(s.latency.percentile(quantile), s.max_ns) / 1e3; };
+        out << fmt::format("{:<20} {:>10} {:>8} {:>12.3f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} "
+                           "{:>10.1f} {:>10.1f}\n",
+                           syscall_name(nr), s.count, s.errors, s.total_ns / 1e6,
+                           s.total_ns / 1e3 / s.count, us(0.5), us(0.9), us(0.99), us(0.999),
+                           s.max_ns / 1e3);
+    }
+
+    // Processos com mais syscalls.
+    std::vector<std::pair<pid_t, ProcessStats>> processes(stats.processes.begin(),
+                                                           stats.processes.end());
+    std::sort(processes.begin(), processes.end(),
+              [](const auto &a, const auto &b)
+              {
+                  if (a.second.count != b.second.count)
+                      return a.second.count > b.second.count;
+                  return a.first < b.first;
+              });
+    processes.resize(std::min(processes.size(), top));
+    out << fmt::format("\n{:<10} {:>12} {:>10} {:>12}\n", "pid", "calls", "errors", "total(ms)");
+    for (const auto &[pid, p] : processes)
+        out << fmt::format("{:<10} {:>12} {:>10} {:>12.3f}\n", pid, p.count, p.errors,
+                           p.total_ns / 1e6);
+
+    // Falhas por syscall e errno.
+    struct ErrorRow
+    {
+        long nr;
+        int err;
+        std::uint64_t count;
+    };
+    std::vector<ErrorRow> errors;
+    for (long nr : order)
+        for (const auto &[err, count] : stats.syscalls[nr].errnos)
+            errors.push_back({nr, err, count});
+    std::sort(errors.begin(), errors.end(),
+              [](const ErrorRow &a, const ErrorRow &b)
+              {
+                  if (a.count != b.count)
+                      return a.count > b.count;
+                  return a.nr != b.nr ? a.nr < b.nr : a.err < b.err;
+              });
+    errors.resize(std::min(errors.size(), top));
+    out << fmt::format("\n{:<20} {:<16} {:>10}\n", "syscall", "errno", "count");
+    for (const ErrorRow &row : errors)
+        out << fmt::format("{:<20} {:<16} {:>10}\n", syscall_name(row.nr), errno_name(row.err),
+                           row.count);
+}
@@ -0,0 +1,56 @@
+#include "TraceRecorder.h" // Headers do projeto
+
+#include "spdlog/spdlog.h" // Usado para registrar erros ao abrir o arquivo
+
+#include <cstring> // Usado pelo memcpy do identificador do formato
+
+/// @brief Quantidade de registros acumulados antes de cada escrita (160 KiB).
+static constexpr std::size_t kBlockRecords = 4096;
+
+TraceRecorder::TraceRecorder(const std::string &path)
+    : m_file(path, std::ios::binary | std::ios::trunc)
+{
+    if (!m_file)
+    {
+        spdlog::error("Não foi possível abrir o arquivo de gravação {}", path);
+        return;
+    }
+    TraceFileHeader header{};
+    std::memcpy(header.magic, TraceRecordFormat::kMagic, sizeof(header.magic));
+    header.version = TraceRecordFormat::kVersion;
+    header.record_size = sizeof(TraceRecord);
+    m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    m_block.reserve(kBlockRecords);
+    spdlog::info("Gravando syscalls em {}", path);
+}
+
+void TraceRecorder::on_syscall_exit(const SyscallEvent &event)
+{
+    if (!m_file)
+        return;
+    TraceRecord record{};
+    record.entry_ns = event.entry_ns;
+    record.exit_ns = event.exit_ns;
+    record.ret = event.ret;
+    record.tid = event.tid;
+    record.pid = event.pid;
+    record.nr = static_cast<std::int32_t>(event.nr);
+    m_block.push_back(record);
+    if (m_block.size() == kBlockRecords)
+        flush();
+}
+
+void TraceRecorder::on_finish()
+{
+    if (!m_file)
+        return;
+    flush();
+    m_file.flush();
+}
+
+void TraceRecorder::flush()
+{
+    m_file.write(reinterpret_cast<const char *>(m_block.data()),
+                 static_cast<std::streamsize>(m_block.size() * sizeof(TraceRecord)));
+    m_block.clear();
+}
@@ -1,50 +1,46 @@
-#include "Tracer.h"  // Headers do projeto
-#include "Syscall.h" // Headers do projeto
+#include "Tracer.h"             // Headers do projeto
+#include "AddressSpace.h"       // Headers do projeto
+#include "BlockedTime.h"        // Headers do projeto
+#include "EventRingPublisher.h" // Headers do projeto
+#include "FutexProfiler.h"      // Headers do projeto
+#include "Metrics.h"            // Headers do projeto
+#include "PatternAdvisor.h"     // Headers do projeto
+#include "PayloadCapture.h"     // Headers do projeto
+#include "ProcessTree.h"        // Headers do projeto
+#include "ProcessMemory.h"      // Headers do projeto
+#include "Syscall.h"            // Headers do projeto
+#include "Timeline.h"           // Headers do projeto
+#include "TraceRecorder.h"      // Headers do projeto
 
 #include "spdlog/spdlog.h" // Usado para fazer o logging do tracer
 
-#include <sys/ptrace.h> // Usado pelo Ptrace
+#include <algorithm> // Usado pelo std::copy dos registradores para o evento
 
-#include <sys/user.h> // Usado pela struct "user_regs_struct" para ler os registradores da CPU.
+#include <chrono> // Usado para marcar o instante de cada parada
 
-#include <sys/wait.h> // Usado pelos macros associadas (WIFEXITED, etc.).
+#include <filesystem> // Usado para navegar em /proc na busca de processos relacionados
 
-/**
- * @brief Lê uma string terminada por nulo da memória de um processo rastreado.
- * @param pid O PID do processo alvo.
- * @param addr O endereço de memória da string no processo alvo.
- * @return A string lida do processo, ou uma mensagem de erro.
- */
-static std::string read_string_from_process(pid_t pid, unsigned long addr)
-{
-    // Um endereço de ponteiro nulo é simplesmente retornado como "NULL".
-    if (addr == 0)
-        return "NULL";
+#include <fstream> // Usado para ler o /proc/[tid]/status e os arquivos 'children'
 
-    // Bloco para ler a memória do processo rastreado (tracee) palavra por palavra.
-    std::string out;
-    for (int i = 0; i < 256 / sizeof(long); ++i)
-    {
-        // PEEKDATA lê uma palavra (long) da memória do tracee.
-        errno = 0;
-        long word = ptrace(PTRACE_PEEKDATA, pid, addr + i * sizeof(long), nullptr);
+#include <poll.h> // Usado para aguardar paradas e comandos de controle ao mesmo tempo
 
-        // Extrai os bytes da palavra e os anexa à string de saída
-        // até que um terminador nulo seja encontrado.
-        // isso é necessário por que só a syscall write possui "count", logo para ser possível
-        // imprimir outras possíveis string essa abordagem é necessaria
-        char *bytes = reinterpret_cast<char *>(&word);
-        for (size_t j = 0; j < sizeof(long); ++j)
-        {
-            if (bytes[j] == '\0')
-                return fmt::format(
-                    "\"{}\"", out); // Retorna a string entre aspas ao encontrar o terminador nulo.
-            out += bytes[j];
-        }
-    }
-    // Se a string for muito longa, ela é truncada.
-    return fmt::format("\"{}...\"", out);
-}
+#include <queue> // Usado pela busca em largura na árvore de processos
+
+#include <set> // Usado para armazenar PIDs únicos na busca de processos
+
+#include <sstream> // Usado para separar a lista de syscalls do filtro
+
+#include <sys/signalfd.h> // Usado para receber o SIGCHLD como um descritor
+
+#include <sys/syscall.h> // Usado pelo SYS_tgkill
+
+#include <unistd.h> // Usado pelo syscall(), close() e getpid()
+
+#include <sys/ptrace.h> // Usado pelo Ptrace
+
+#include <sys/user.h> // Usado pela struct "user_regs_struct" para ler os registradores da CPU.
+
+#include <sys/wait.h> // Usado pelos macros associadas (WIFEXITED, etc.).
 
 /**
  * @brief Formata um argumento de syscall para logging com base em seu tipo e valor.
@@ -58,7 +54,7 @@ static std::string format_argument(pid_t pid, const std::string &type, long long
     if (type.find("char") != std::string::npos &&
         type.find('*') != std::string::npos) // Condicional que procura 'char' E '*'
         // dentro da string "type"
-        return read_string_from_process(pid, (unsigned long)value);
+        return ProcessMemory::read_string(pid, (unsigned long)value);
     // Para números grandes, formata como hexadecimal para legibilidade (provavelmente um endereço
     // ou flags).
     if (value > 1000000)
@@ -68,10 +64,158 @@ static std::string format_argument(pid_t pid, const std::string &type, long long
 }
 
 /**
- * @brief Cria um fork do processo atual para gerar um filho, que é então rastreado.
- * @param args Os argumentos da linha de comando do programa a ser executado no filho.
+ * @brief Escreve a linha de entrada de uma syscall com os argumentos já formatados.
+ * @param event O evento da chamada.
+ */
+static void print_syscall_entry(const SyscallEvent &event)
+{
+    if (auto info = Syscall::get_syscall_info(event.nr))
+    {
+        spdlog::info("SYSCALL_ENTRY [PID:{}] {}({})", event.tid, info->name, event.args_str);
+    }
+    else
+    {
+        spdlog::warn("SYSCALL_ENTRY [PID:{}] unknown {}", event.tid, event.nr);
+    }
+}
+
+/**
+ * @brief Retorna o instante atual de um relógio monotônico.
+ * @return O instante em nanossegundos.
+ */
+static std::uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * @brief Lê um campo numérico de /proc/[tid]/status.
+ * @param tid O TID da thread.
+ * @param key O nome do campo, com os dois-pontos (ex: "Tgid:").
+ * @param fallback O valor devolvido se a leitura falhar.
+ */
+static pid_t read_status_pid(pid_t tid, const std::string &key, pid_t fallback)
+{
+    std::ifstream status("/proc/" + std::to_string(tid) + "/status");
+    std::string field;
+    while (status >> field)
+    {
+        if (field == key)
+        {
+            pid_t value = fallback;
+            status >> value;
+            return value;
+        }
+        status.ignore(4096, '\n'); // Pula o resto da linha.
+    }
+    return fallback;
+}
+
+/**
+ * @brief Descobre o PID (tgid) do processo ao qual uma thread pertence.
+ * @param tid O TID da thread.
+ * @return O tgid lido de /proc/[tid]/status, ou o próprio TID se a leitura falhar.
+ */
+static pid_t read_tgid(pid_t tid)
+{
+    return read_status_pid(tid, "Tgid:", tid);
+}
+
+/**
+ * @brief Monta as opções do ptrace de uma thread rastreada: paradas de syscall, clones, forks,
+ * vforks e execs.
+ * @param exit_stops Também para a thread no PTRACE_EVENT_EXIT, para quem lê o /proc dela antes do
+ * término.
+ * @param exit_kill Mata a thread se o rastreador terminar; só para processos criados por ele.
+ */
+static long trace_options(bool exit_stops, bool exit_kill)
+{
+    long options = PTRACE_O_TRACESYSGOOD | PTRACE_O_TRACECLONE | PTRACE_O_TRACEFORK |
+                   PTRACE_O_TRACEVFORK | PTRACE_O_TRACEEXEC;
+    if (exit_stops)
+    {
+        options |= PTRACE_O_TRACEEXIT;
+    }
+    if (exit_kill)
+    {
+        options |= PTRACE_O_EXITKILL;
+    }
+    return options;
+}
+
+/**
+ * @brief Encontra todos os processos e threads descendentes de um determinado PID raiz.
+ * @param root_pid O ID do processo a partir do qual a busca deve ser iniciada.
+ * @return Um vetor contendo todos os PIDs e TIDs relacionados.
  */
-void fork_and_trace(const std::vector<std::string> &args)
+std::vector<pid_t> find_all_related(pid_t root_pid)
+{
+    // Bloco de código que inicializa o conjunto de pids relacionados a um pid
+    std::set<pid_t> pids;
+    std::queue<pid_t> q;
+    q.push(root_pid);
+
+    // Loop que vai percorrer procurar todos pids relacionados ao pid raiz
+    while (!q.empty())
+    {
+        pid_t current_pid = q.front();
+        q.pop();
+        std::string task_path = "/proc/" + std::to_string(current_pid) + "/task";
+        if (!std::filesystem::exists(task_path))
+        {
+            continue;
+        }
+
+        // Para o processo atual, itera sobre suas threads em /proc/[pid]/task.
+        // Adiciona o ID de cada thread (TID) à lista e verifica se a thread possui
+        // processos filhos, adicionando-os à fila de busca se ainda não foram vistos.
+        for (const auto &entry : std::filesystem::directory_iterator(task_path))
+        {
+            pid_t tid = std::stoi(entry.path().filename().string());
+            pids.insert(tid);
+            std::string children_path = entry.path().string() + "/children";
+            std::ifstream children_file(children_path);
+            pid_t child_pid;
+            while (children_file >> child_pid)
+            {
+                if (pids.find(child_pid) == pids.end())
+                {
+                    q.push(child_pid);
+                }
+            }
+        }
+    }
+
+    // Converte o conjunto de PIDs em um vetor e o retorna.
+    return {pids.begin(), pids.end()};
+}
+
+std::vector<pid_t> attach_tree(pid_t root_pid)
+{
+    std::vector<pid_t> attached;
+    // Loop para configurar o ptrace de cada um dos pids a serem escutados
+    for (pid_t pid : find_all_related(root_pid))
+    {
+        if (ptrace(PTRACE_ATTACH, pid, nullptr, nullptr) == -1) // Inicializa o Ptrace no pid atual
+        {
+            spdlog::warn("Attach do processo {} falhou: {}", pid, strerror(errno));
+            continue;
+        }
+        // Espera o SIGSTOP do PTRACE_ATTACH, ou seja, que a anexação foi concluída antes de
+        // configurar as opções. __WALL inclui threads que não são a principal do processo.
+        waitpid(pid, nullptr, __WALL);
+        // Setar as configurações do ptrace, basicamente fazendo ele escutar chamadas de sistema,
+        // clones, forks, vforks e execs. As paradas de término são pedidas no run(), se algum
+        // consumidor precisar delas.
+        ptrace(PTRACE_SETOPTIONS, pid, nullptr, trace_options(false, false));
+        attached.push_back(pid);
+    }
+    return attached;
+}
+
+pid_t spawn_traced(const std::vector<std::string> &args)
 {
     // Cria um processo filho.
     pid_t child = fork();
@@ -104,24 +248,115 @@ void fork_and_trace(const std::vector<std::string> &args)
     waitpid(child, &status, 0);
 
     // Configura as opções do ptrace no filho para rastrear syscalls e futuros forks/clones/execs.
-    ptrace(PTRACE_SETOPTIONS, child, nullptr,
-           PTRACE_O_TRACESYSGOOD | PTRACE_O_TRACECLONE | PTRACE_O_TRACEFORK | PTRACE_O_TRACEVFORK |
-               PTRACE_O_TRACEEXEC | PTRACE_O_EXITKILL);
-    // Continua a execução do filho e diz para ele parar na próxima entrada ou saída de syscall.
-    ptrace(PTRACE_SYSCALL, child, nullptr, nullptr);
+    // O filho continua parado; o Tracer o resume no início do run().
+    ptrace(PTRACE_SETOPTIONS, child, nullptr, trace_options(false, true));
+    return child;
+}
 
+/**
+ * @brief Cria um fork do processo atual para gerar um filho, que é então rastreado.
+ * @param args Os argumentos da linha de comando do programa a ser executado no filho.
+ */
+void fork_and_trace(const std::vector<std::string> &args, const TracerOptions &options)
+{
     // Cria e executa a instância do Tracer com o PID do novo filho.
-    std::vector<pid_t> pids_to_trace = {child};
-    Tracer tracer(pids_to_trace);
+    std::vector<pid_t> pids_to_trace = {spawn_traced(args)};
+    Tracer tracer(pids_to_trace, options);
     tracer.run();
 }
 
 /**
  * @brief Constrói um Tracer e inicializa seu estado interno.
  * @param pids Um vetor de PIDs iniciais para rastrear.
+ * @param options As opções que ativam as análises opcionais.
  */
-Tracer::Tracer(const std::vector<pid_t> &pids)
+Tracer::Tracer(const std::vector<pid_t> &pids, const TracerOptions &options)
+    : m_start_pids(pids), m_log_syscalls(options.log_syscalls)
 {
+    // O canal de controle e o governador são criados antes de qualquer thread auxiliar (ex: o
+    // servidor de métricas), pois o SIGCHLD precisa estar bloqueado em todas as threads para
+    // chegar ao signalfd.
+    if (!options.control_path.empty())
+    {
+        m_control = std::make_unique<ControlChannel>(options.control_path);
+        if (m_control->fd() < 0)
+        {
+            m_control.reset();
+        }
+    }
+    if (options.overhead_budget > 0)
+    {
+        m_governor = std::make_unique<OverheadGovernor>(options.overhead_budget,
+                                                        options.overhead_sampling, now_ns());
+    }
+    if (m_control || m_governor)
+    {
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGCHLD);
+        pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+        m_signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    }
+
+    std::string error;
+    if (!options.syscall_filter.empty() && !set_syscall_filter(options.syscall_filter, error))
+    {
+        spdlog::error("Filtro de syscalls ignorado: {}", error);
+    }
+
+    m_filter = options.filter;
+
+    // Cria os consumidores de eventos pedidos nas opções.
+    if (options.blocked_report_top > 0)
+    {
+        m_sinks.push_back(std::make_unique<BlockedTimeProfiler>(options.blocked_report_top));
+    }
+    if (options.futex_report_top > 0)
+    {
+        m_sinks.push_back(std::make_unique<FutexProfiler>(options.futex_report_top));
+    }
+    if (options.process_tree_top > 0)
+    {
+        m_sinks.push_back(std::make_unique<ProcessTreeProfiler>(options.process_tree_top));
+    }
+    if (!options.metrics_listen.empty())
+    {
+        m_sinks.push_back(std::make_unique<MetricsExporter>(options.metrics_listen));
+    }
+    if (!options.timeline_path.empty())
+    {
+        if (auto timeline = TimelineExporter::create(options.timeline_path))
+        {
+            m_sinks.push_back(std::move(timeline));
+        }
+    }
+    if (options.advise)
+    {
+        m_sinks.push_back(std::make_unique<PatternAdvisor>());
+    }
+    if (!options.record_path.empty())
+    {
+        m_sinks.push_back(std::make_unique<TraceRecorder>(options.record_path));
+    }
+    if (!options.memory_profile_path.empty())
+    {
+        m_sinks.push_back(std::make_unique<AddressSpaceProfiler>(options.memory_profile_path));
+    }
+    if (!options.shm_ring_name.empty())
+    {
+        auto ring =
+            std::make_unique<EventRingPublisher>(options.shm_ring_name, options.shm_ring_slots);
+        if (ring->valid())
+        {
+            m_sinks.push_back(std::move(ring));
+        }
+    }
+    if (!options.capture_syscalls.empty())
+    {
+        m_payload = std::make_unique<PayloadCapture>(
+            options.capture_syscalls, options.capture_max_bytes, options.capture_path);
+    }
+
     // Este loop inicializa o estado para cada PID que está sendo rastreado.
     // Toda thread é inicialmente marcada como não estando em uma syscall e não tendo acabado de
     // executar um exec.
@@ -129,7 +364,22 @@ Tracer::Tracer(const std::vector<pid_t> &pids)
     {
         m_threads_in_syscall[pid] = false;
         m_just_execed[pid] = false;
+        m_tgid[pid] = read_tgid(pid);
         spdlog::info("Rastreando PID {}", pid);
+        classify_thread(pid);
+    }
+}
+
+void Tracer::add_sink(std::unique_ptr<TraceSink> sink)
+{
+    m_sinks.push_back(std::move(sink));
+}
+
+Tracer::~Tracer()
+{
+    if (m_signal_fd >= 0)
+    {
+        close(m_signal_fd);
     }
 }
 
@@ -141,12 +391,40 @@ Tracer::Tracer(const std::vector<pid_t> &pids)
  */
 void Tracer::run()
 {
-    // O loop continua enquanto houver threads sendo rastreadas.
-    while (!m_threads_in_syscall.empty())
+    // As threads iniciais estão paradas desde o attach ou o fork. Só são resumidas agora, com
+    // todos os consumidores registrados, para que nenhuma syscall passe sem ser vista.
+    // Sem ninguém que use syscalls, as threads rodam com PTRACE_CONT e só param nos eventos de
+    // processo. O governador não conta como consumidor: ele só mede as paradas que os
+    // consumidores já pedem, e pedir as suas próprias criaria o custo que ele deve limitar.
+    m_syscall_stops = m_log_syscalls || m_payload;
+    for (const auto &sink : m_sinks)
+    {
+        m_syscall_stops = m_syscall_stops || sink->wants_syscalls();
+        m_exit_stops = m_exit_stops || sink->wants_exit_stops();
+    }
+    for (pid_t pid : m_start_pids)
+    {
+        // attach_tree() e spawn_traced() não pedem as paradas de término. Só o filho criado por
+        // spawn_traced() (o rastreador é o pai dele) mantém o PTRACE_O_EXITKILL.
+        if (m_exit_stops)
+        {
+            ptrace(PTRACE_SETOPTIONS, pid, nullptr,
+                   trace_options(true, read_status_pid(pid, "PPid:", 0) == getpid()));
+        }
+        resume_thread(pid, 0);
+    }
+    m_start_pids.clear();
+
+    // O loop continua enquanto houver threads sendo rastreadas ou sendo anexadas.
+    while (!m_threads_in_syscall.empty() || !m_pending_stop.empty())
     {
         int status = 0;
-        // waitpid com -1 aguarda por qualquer processo filho. __WALL inclui threads.
-        pid_t pid = waitpid(-1, &status, __WALL);
+        pid_t pid = wait_for_stop(status);
+        std::uint64_t now = now_ns(); // Instante da parada, usado para medir as syscalls.
+        if (m_governor && now >= m_governor->deadline())
+        {
+            tick_governor(now);
+        }
 
         // Se waitpid retornar um erro.
         if (pid <= 0)
@@ -162,9 +440,19 @@ void Tracer::run()
         // Este bloco lida com um processo que terminou ou foi encerrado por um sinal.
         if (WIFEXITED(status) || WIFSIGNALED(status))
         {
+            if (m_tgid.count(pid))
+            {
+                ProcessEvent exited;
+                exited.type = ProcessEventType::Exit;
+                exited.tid = pid;
+                exited.pid = m_tgid[pid];
+                exited.status = status;
+                exited.ts_ns = now;
+                notify_process_event(exited);
+            }
+
             // Remove o PID que saiu dos mapas para parar de rastreá-lo.
-            m_threads_in_syscall.erase(pid);
-            m_just_execed.erase(pid);
+            forget_thread(pid);
             continue;
         }
 
@@ -174,23 +462,53 @@ void Tracer::run()
             continue;
         }
 
+        // Paradas causadas pelo SIGSTOP que o próprio Tracer enviou (attach, resume, detach).
+        if (!m_pending_stop.empty() && handle_pending_stop(pid, status))
+        {
+            continue;
+        }
+
         // Isso pode acontecer se uma nova thread for criada mas ainda não estiver sendo rastreada.
         if (!m_threads_in_syscall.count(pid))
         {
+            // O SIGSTOP inicial de um filho pode chegar antes do evento de fork do pai. O filho
+            // fica parado até o evento, senão as suas primeiras paradas de syscall seriam
+            // consumidas aqui e a alternância entre entrada e saída ficaria invertida.
+            if (WSTOPSIG(status) == SIGSTOP && ((unsigned)status >> 16) == 0)
+            {
+                m_early_children.insert(pid);
+                continue;
+            }
             ptrace(PTRACE_SYSCALL, pid, nullptr, nullptr); // Resume sua execução.
             continue;
         }
 
-        // Eventos do Ptrace (como fork, clone, exec) são codificados no status.
+        // O SIGSTOP inicial de um filho já registrado é só a notificação do auto-attach, e não
+        // deve ser entregue ao processo.
         unsigned event = (unsigned)status >> 16;
+        if (event == 0 && WSTOPSIG(status) == SIGSTOP && m_new_children.erase(pid))
+        {
+            resume_thread(pid, 0);
+            continue;
+        }
+
+        // Eventos do Ptrace (como fork, clone, exec) são codificados no status.
         if (event)
         {
             switch (event)
             {
             // Um processo chamou execve.
             case PTRACE_EVENT_EXEC:
+            {
                 m_just_execed[pid] = true;
+                ProcessEvent execed;
+                execed.type = ProcessEventType::Exec;
+                execed.tid = pid;
+                execed.pid = m_tgid[pid];
+                execed.ts_ns = now;
+                notify_process_event(execed);
                 break;
+            }
 
             // Um processo usou fork ou clone para criar um novo processo/thread.
             case PTRACE_EVENT_FORK:
@@ -204,21 +522,61 @@ void Tracer::run()
 
                 // Configura as mesmas opções de ptrace no novo processo para que ele também seja
                 // rastreado.
-                ptrace(PTRACE_SETOPTIONS, newpid, nullptr,
-                       PTRACE_O_TRACESYSGOOD | PTRACE_O_TRACECLONE | PTRACE_O_TRACEFORK |
-                           PTRACE_O_TRACEVFORK | PTRACE_O_TRACEEXEC | PTRACE_O_EXITKILL);
+                ptrace(PTRACE_SETOPTIONS, newpid, nullptr, trace_options(m_exit_stops, true));
 
                 // Adiciona o novo PID aos nossos mapas para começar a rastreá-lo.
                 m_threads_in_syscall[newpid] = false;
                 m_just_execed[newpid] = false;
+                // Fork e vfork sempre criam um processo novo. Um clone pode criar uma thread do
+                // mesmo processo ou um processo novo, dependendo das flags.
+                m_tgid[newpid] = event == PTRACE_EVENT_CLONE ? read_tgid(newpid) : newpid;
+                classify_thread(newpid);
 
-                // Resume o novo processo e o faz parar na próxima syscall.
-                ptrace(PTRACE_SYSCALL, newpid, nullptr, nullptr);
+                ProcessEvent spawned;
+                spawned.type = event == PTRACE_EVENT_FORK    ? ProcessEventType::Fork
+                               : event == PTRACE_EVENT_VFORK ? ProcessEventType::Vfork
+                                                             : ProcessEventType::Clone;
+                spawned.tid = pid;
+                spawned.pid = m_tgid[pid];
+                spawned.child_tid = newpid;
+                spawned.child_pid = m_tgid[newpid];
+                spawned.ts_ns = now;
+                notify_process_event(spawned);
+
+                // Resume o novo processo e o faz parar na próxima syscall, se ele já parou. Senão,
+                // ele é resumido quando o seu SIGSTOP inicial chegar.
+                if (m_early_children.erase(newpid))
+                {
+                    resume_thread(newpid, 0);
+                }
+                else
+                {
+                    m_new_children.insert(newpid);
+                }
+                break;
+            }
+            // Uma thread está terminando. O /proc dela ainda pode ser lido, o que não acontece mais
+            // quando o waitpid retorna o término.
+            case PTRACE_EVENT_EXIT:
+            {
+                unsigned long code = 0;
+                ptrace(PTRACE_GETEVENTMSG, pid, nullptr, &code);
+                ProcessEvent exiting;
+                exiting.type = ProcessEventType::Exiting;
+                exiting.tid = pid;
+                exiting.pid = m_tgid[pid];
+                exiting.status = (int)code;
+                exiting.ts_ns = now;
+                notify_process_event(exiting);
                 break;
             }
             default:
                 break;
             }
+
+            // Paradas de evento não são sinais para o processo; nada é encaminhado.
+            resume_thread(pid, 0);
+            continue;
         }
 
         // WSTOPSIG obtém o sinal que causou a parada.
@@ -228,56 +586,551 @@ void Tracer::run()
         {
             // Esta lógica diferencia entre a entrada e a saída de uma syscall.
             bool &in = m_threads_in_syscall[pid];
-            if (!in)
+            if (m_paused)
+            {
+                // Paradas que já estavam agendadas antes da pausa são ignoradas, e a thread passa
+                // a rodar sem paradas de syscall.
+                in = false;
+            }
+            else if (!in)
             {
                 // Se não está em uma syscall, esta é uma entrada de syscall.
-                log_syscall_entry(pid);
+                handle_syscall_entry(pid, now);
                 in = true; // Marca como dentro de uma syscall.
             }
             else
             {
                 // Se já está em uma syscall, esta é uma saída de syscall.
                 // Tratamento especial para a mensagem de sucesso do execve.
-                if (m_just_execed[pid])
-                {
-                    m_just_execed[pid] = false;
-                }
-                else
-                {
-                    log_syscall_exit(pid);
-                }
+                handle_syscall_exit(pid, now, !m_just_execed[pid]);
+                m_just_execed[pid] = false;
                 in = false; // Marca como não estando mais em uma syscall.
             }
             // Resume o processo e o faz parar no próximo evento de syscall.
-            ptrace(PTRACE_SYSCALL, pid, nullptr, nullptr);
+            resume_thread(pid, 0);
         }
         else
         {
             // Se for um sinal diferente, o encaminha para o processo e continua o rastreamento.
-            ptrace(PTRACE_SYSCALL, pid, nullptr, sig);
+            resume_thread(pid, sig);
+        }
+    }
+
+    // Com o loop encerrado, os consumidores emitem seus relatórios.
+    if (m_governor)
+    {
+        m_governor->report();
+    }
+    for (auto &sink : m_sinks)
+    {
+        sink->on_finish();
+    }
+}
+
+pid_t Tracer::wait_for_stop(int &status)
+{
+    // Sem canal de controle nem governador, basta bloquear no waitpid. waitpid com -1 aguarda
+    // por qualquer processo filho. __WALL inclui threads.
+    if (m_signal_fd < 0)
+    {
+        return waitpid(-1, &status, __WALL);
+    }
+
+    // Com o canal de controle ou o governador, as paradas pendentes são consumidas sem bloquear.
+    // Quando não há nenhuma, o loop dorme no poll até chegar um SIGCHLD (pelo signalfd), um
+    // comando ou o prazo do governador, já que threads amostradas em PTRACE_CONT não param.
+    while (true)
+    {
+        pid_t pid = waitpid(-1, &status, __WALL | WNOHANG);
+        if (pid != 0)
+        {
+            return pid;
+        }
+
+        int timeout = -1;
+        if (m_governor)
+        {
+            std::uint64_t now = now_ns();
+            if (now >= m_governor->deadline())
+            {
+                tick_governor(now);
+                continue;
+            }
+            timeout = static_cast<int>((m_governor->deadline() - now + 999999) / 1000000);
+        }
+        std::vector<pollfd> fds = {{m_signal_fd, POLLIN, 0}};
+        if (m_control)
+        {
+            m_control->poll_fds(fds);
+        }
+        if (poll(fds.data(), fds.size(), timeout) < 0 && errno != EINTR)
+        {
+            // Repetir o poll só falharia de novo (ENOMEM, EBADF) e giraria o loop sem parar. O
+            // rastreamento continua no waitpid bloqueante, sem atender mais os comandos de controle
+            // nem os prazos do governador.
+            spdlog::error("poll falhou: {}; o canal de controle e o governador deixam de ser "
+                          "atendidos",
+                          strerror(errno));
+            close(m_signal_fd);
+            m_signal_fd = -1;
+            return waitpid(-1, &status, __WALL);
+        }
+        if (fds[0].revents & POLLIN)
+        {
+            // Esvazia o signalfd; os SIGCHLD são agrupados e o waitpid acima trata todos.
+            signalfd_siginfo info{};
+            while (read(m_signal_fd, &info, sizeof(info)) == sizeof(info))
+            {
+            }
+        }
+        // Uma conexão nova ou dados de um cliente; o canal só lê o que já chegou, e guarda as
+        // linhas incompletas para a próxima volta.
+        bool control_ready = false;
+        for (std::size_t i = 1; i < fds.size(); ++i)
+        {
+            control_ready = control_ready || fds[i].revents != 0;
+        }
+        ControlCommand command;
+        while (control_ready && m_control->receive(command))
+        {
+            handle_control_command(command);
+        }
+    }
+}
+
+void Tracer::tick_governor(std::uint64_t now_ns)
+{
+    for (pid_t tid : m_governor->tick(now_ns))
+    {
+        // Um SIGSTOP já a caminho (attach, detach) tem prioridade, e a thread pode ter terminado.
+        if (m_threads_in_syscall.count(tid) && !m_pending_stop.count(tid))
+        {
+            request_stop(tid, PendingStop::Resume);
+        }
+    }
+}
+
+void Tracer::handle_control_command(const ControlCommand &command)
+{
+    std::string error;
+    switch (command.type)
+    {
+    case ControlCommand::Type::Pause:
+        // A pausa é aplicada na próxima parada de cada thread, que passa a ser resumida com
+        // PTRACE_CONT. Threads bloqueadas em syscalls não geram custo enquanto estão bloqueadas.
+        m_paused = true;
+        break;
+
+    case ControlCommand::Type::Resume:
+        // Threads em PTRACE_CONT não param mais sozinhas, então cada uma recebe um SIGSTOP e
+        // volta para PTRACE_SYSCALL quando ele chegar.
+        if (m_paused)
+        {
+            m_paused = false;
+            for (const auto &[tid, in] : m_threads_in_syscall)
+            {
+                request_stop(tid, PendingStop::Resume);
+            }
+        }
+        break;
+
+    case ControlCommand::Type::Filter:
+        set_syscall_filter(command.argument, error);
+        break;
+
+    case ControlCommand::Type::Add:
+        if (attach_process(command.pid) == 0)
+        {
+            error = fmt::format("could not attach to {}", command.pid);
+        }
+        break;
+
+    case ControlCommand::Type::Remove:
+    {
+        std::size_t found = 0;
+        for (const auto &[tid, tgid] : m_tgid)
+        {
+            if (tgid == command.pid)
+            {
+                request_stop(tid, PendingStop::Detach);
+                ++found;
+            }
+        }
+        if (found == 0)
+        {
+            error = fmt::format("pid {} is not being traced", command.pid);
         }
+        break;
     }
+
+    case ControlCommand::Type::Detach:
+        for (const auto &[tid, in] : m_threads_in_syscall)
+        {
+            request_stop(tid, PendingStop::Detach);
+        }
+        break;
+    }
+    ControlChannel::reply(command, error);
 }
 
-void Tracer::log_syscall_entry(pid_t pid)
+bool Tracer::handle_pending_stop(pid_t pid, int status)
+{
+    const auto it = m_pending_stop.find(pid);
+    if (it == m_pending_stop.end())
+    {
+        return false;
+    }
+
+    // Só o SIGSTOP enviado pelo Tracer conclui a ação; outras paradas seguem o fluxo normal.
+    bool our_stop = WSTOPSIG(status) == SIGSTOP && ((unsigned)status >> 16) == 0;
+    PendingStop action = it->second;
+    if (!our_stop)
+    {
+        if (action != PendingStop::Attach)
+        {
+            return false;
+        }
+        // A thread ainda não foi configurada, então apenas entrega o sinal e continua esperando.
+        ptrace(PTRACE_CONT, pid, nullptr, WSTOPSIG(status));
+        return true;
+    }
+    m_pending_stop.erase(it);
+
+    switch (action)
+    {
+    case PendingStop::Attach:
+        ptrace(PTRACE_SETOPTIONS, pid, nullptr, trace_options(m_exit_stops, false));
+        m_threads_in_syscall[pid] = false;
+        m_just_execed[pid] = false;
+        m_tgid[pid] = read_tgid(pid);
+        spdlog::info("Rastreando PID {}", pid);
+        classify_thread(pid);
+        resume_thread(pid, 0);
+        break;
+
+    case PendingStop::Resume:
+        // Uma parada de entrega de sinal nunca acontece dentro de uma syscall.
+        m_threads_in_syscall[pid] = false;
+        resume_thread(pid, 0);
+        break;
+
+    case PendingStop::Detach:
+        // Desanexar consumindo o próprio SIGSTOP evita que ele pare o processo depois.
+        ptrace(PTRACE_DETACH, pid, nullptr, nullptr);
+        spdlog::info("Desanexado do PID {}", pid);
+        forget_thread(pid);
+        break;
+    }
+    return true;
+}
+
+void Tracer::request_stop(pid_t tid, PendingStop action)
+{
+    // Se já existe um SIGSTOP a caminho, só a ação muda. Um segundo SIGSTOP ficaria pendente e
+    // pararia o processo depois de um detach.
+    auto [it, inserted] = m_pending_stop.try_emplace(tid, action);
+    if (!inserted)
+    {
+        it->second = action;
+        return;
+    }
+    pid_t tgid = m_tgid.count(tid) ? m_tgid[tid] : tid;
+    if (syscall(SYS_tgkill, tgid, tid, SIGSTOP) < 0)
+    {
+        m_pending_stop.erase(it);
+    }
+}
+
+void Tracer::resume_thread(pid_t pid, int sig)
+{
+    if (m_paused || !m_syscall_stops ||
+        (!m_excluded_threads.empty() && m_excluded_threads.count(pid)) ||
+        (m_governor && m_governor->sampled_out(pid)))
+    {
+        // Sem paradas de syscall, a saída da syscall atual não será vista.
+        m_threads_in_syscall[pid] = false;
+        ptrace(PTRACE_CONT, pid, nullptr, sig);
+        return;
+    }
+    ptrace(PTRACE_SYSCALL, pid, nullptr, sig);
+}
+
+std::size_t Tracer::attach_process(pid_t pid)
+{
+    std::size_t attached = 0;
+    for (pid_t tid : find_all_related(pid))
+    {
+        if (m_threads_in_syscall.count(tid) || m_pending_stop.count(tid))
+        {
+            continue;
+        }
+        if (ptrace(PTRACE_ATTACH, tid, nullptr, nullptr) == -1)
+        {
+            spdlog::warn("Attach do processo {} falhou: {}", tid, strerror(errno));
+            continue;
+        }
+        // O PTRACE_ATTACH envia o SIGSTOP; a configuração acontece quando ele chegar.
+        m_pending_stop[tid] = PendingStop::Attach;
+        ++attached;
+    }
+    return attached;
+}
+
+bool Tracer::set_syscall_filter(const std::string &list, std::string &error)
+{
+    if (list == "all")
+    {
+        m_syscall_filter.clear();
+        spdlog::info("Filtro de syscalls removido");
+        return true;
+    }
+
+    std::vector<bool> filter;
+    std::stringstream names(list);
+    std::string name;
+    while (std::getline(names, name, ','))
+    {
+        long nr = Syscall::find_syscall_number(name);
+        if (nr < 0)
+        {
+            error = "unknown syscall '" + name + "'";
+            return false;
+        }
+        if (static_cast<std::size_t>(nr) >= filter.size())
+        {
+            filter.resize(nr + 1, false);
+        }
+        filter[nr] = true;
+    }
+    if (filter.empty())
+    {
+        error = "empty syscall list";
+        return false;
+    }
+    m_syscall_filter = std::move(filter);
+    spdlog::info("Filtro de syscalls: {}", list);
+    return true;
+}
+
+void Tracer::forget_thread(pid_t pid)
+{
+    m_threads_in_syscall.erase(pid);
+    m_just_execed.erase(pid);
+    m_current_syscall.erase(pid);
+    m_skip_syscall.erase(pid);
+    m_tgid.erase(pid);
+    m_pending_stop.erase(pid);
+    m_early_children.erase(pid);
+    m_new_children.erase(pid);
+    m_filter_at_exit.erase(pid);
+    m_wanted_by.erase(pid);
+    if (m_payload)
+    {
+        m_payload->discard_entry(pid);
+    }
+    m_excluded_threads.erase(pid);
+    if (m_governor)
+    {
+        m_governor->forget(pid);
+    }
+}
+
+void Tracer::classify_thread(pid_t pid)
+{
+    if (!m_filter)
+    {
+        return;
+    }
+    // O ptrace não filtra syscalls no kernel; a única decisão que pode ser antecipada é parar
+    // ou não em cada syscall da thread, e ela só depende do pid e do tid.
+    SyscallEvent thread;
+    thread.tid = pid;
+    thread.pid = m_tgid[pid];
+    if (m_filter->evaluate(thread, FilterProgram::Phase::Thread) == FilterProgram::Result::False)
+    {
+        m_excluded_threads.insert(pid);
+        spdlog::debug("PID {} excluído pelo filtro, rodando sem paradas de syscall", pid);
+    }
+}
+
+void Tracer::notify_process_event(const ProcessEvent &event)
+{
+    for (auto &sink : m_sinks)
+    {
+        sink->on_process_event(event);
+    }
+}
+
+void Tracer::handle_syscall_entry(pid_t pid, std::uint64_t now_ns)
 {
     user_regs_struct regs{};
     ptrace(PTRACE_GETREGS, pid, nullptr, &regs); // Pegar os valores nos registradores
+
+    // Reinicia o evento pendente da thread com o que é conhecido na entrada.
+    SyscallEvent &event = m_current_syscall[pid];
+    event.tid = pid;
+    event.pid = m_tgid[pid];
+    event.nr = (long)regs.orig_rax;
+    const unsigned long long vals[] = {regs.rdi, regs.rsi, regs.rdx,
+                                       regs.r10, regs.r8,  regs.r9}; // Os 6 registradores de valor
+    std::copy(std::begin(vals), std::end(vals), std::begin(event.args));
+
+    // Syscalls que o governador só conta são tratadas como fora do filtro.
+    bool counted_only = m_governor && m_governor->record(pid, event.nr);
+
+    // Syscalls fora do filtro não são formatadas, registradas nem repassadas aos sinks. Os dois
+    // filtros só usam os registradores, antes de qualquer leitura da memória do processo.
+    bool skip = counted_only ||
+                (!m_syscall_filter.empty() &&
+                 (event.nr < 0 || static_cast<std::size_t>(event.nr) >= m_syscall_filter.size() ||
+                  !m_syscall_filter[event.nr]));
+    bool filter_at_exit = false;
+    if (!skip && m_filter)
+    {
+        auto result = m_filter->evaluate(event, FilterProgram::Phase::Entry);
+        skip = result == FilterProgram::Result::False;
+        filter_at_exit = result == FilterProgram::Result::Unknown;
+    }
+    event.ip = regs.rip;
+    event.ret = 0;
+    event.entry_ns = now_ns;
+    event.exit_ns = 0;
+    event.payload_len = 0;
+
+    // Cada consumidor diz o quanto da chamada precisa. Sem o log, uma chamada que nenhum deles
+    // quer é tratada como fora do filtro, e a sua saída nem é lida.
+    CaptureLevel level = m_log_syscalls ? CaptureLevel::Decoded : CaptureLevel::Skip;
+    std::vector<bool> &wanted = m_wanted_by[pid];
+    wanted.assign(m_sinks.size(), false);
+    for (std::size_t i = 0; !skip && i < m_sinks.size(); ++i)
+    {
+        CaptureLevel sink_level = m_sinks[i]->on_syscall_entry(event);
+        wanted[i] = sink_level != CaptureLevel::Skip;
+        level = std::max(level, sink_level);
+    }
+    skip = skip || level == CaptureLevel::Skip;
+
+    m_skip_syscall[pid] = skip;
+    m_filter_at_exit[pid] = filter_at_exit;
+    if (skip)
+    {
+        event.entry_ns = 0;
+        return;
+    }
+
+    // Buffers de escrita precisam ser copiados antes que a syscall os consuma. Se o filtro só
+    // decide na saída, a cópia fica guardada até lá e só é gravada se a chamada passar.
+    if (m_payload)
+    {
+        m_payload->capture_entry(event, filter_at_exit);
+    }
+
+    if (level == CaptureLevel::Decoded)
+    {
+        log_syscall_entry(event, m_log_syscalls && !filter_at_exit);
+    }
+    else
+    {
+        event.args_str.clear();
+    }
+}
+
+void Tracer::handle_syscall_exit(pid_t pid, std::uint64_t now_ns, bool log)
+{
+    if (m_skip_syscall[pid])
+    {
+        return;
+    }
+    log = log && m_log_syscalls;
+
+    user_regs_struct regs{};
+    ptrace(PTRACE_GETREGS, pid, nullptr, &regs);
+
+    SyscallEvent &event = m_current_syscall[pid];
+    event.tid = pid;
+    event.nr = (long)regs.orig_rax; // O número da syscall ainda está em 'orig_rax'.
+    event.ret = (long long)regs.rax; // O valor de retorno em x86-64 está no registrador 'rax'.
+    event.exit_ns = now_ns;
+
+    // Filtros que dependem do resultado só podem ser decididos agora. A entrada, que já foi
+    // formatada, é registrada junto com a saída quando o filtro passa.
+    if (m_filter_at_exit[pid] && event.entry_ns != 0)
+    {
+        if (m_filter->evaluate(event, FilterProgram::Phase::Exit) != FilterProgram::Result::True)
+        {
+            if (m_payload)
+            {
+                m_payload->discard_entry(pid);
+            }
+            event.entry_ns = 0;
+            return;
+        }
+        // A entrada já foi formatada com o ponteiro do buffer; a referência ao payload vai
+        // para a linha de saída, como nas leituras.
+        if (m_payload)
+        {
+            m_payload->commit_entry(event);
+        }
+        if (log)
+        {
+            print_syscall_entry(event);
+        }
+    }
+
+    // Buffers de leitura só têm conteúdo depois que o kernel os preencheu.
+    if (m_payload && event.entry_ns != 0)
+    {
+        m_payload->capture_exit(event);
+    }
+
+    if (log)
+    {
+        log_syscall_exit(event, m_filter_at_exit[pid]);
+    }
+
+    // Só notifica os consumidores se a entrada desta chamada também foi observada, o que não
+    // acontece, por exemplo, quando o anexo ocorre com a thread já dentro de uma syscall.
+    if (event.entry_ns != 0)
+    {
+        // Um consumidor registrado depois da entrada não a viu, e não recebe a saída.
+        const std::vector<bool> &wanted = m_wanted_by[pid];
+        for (std::size_t i = 0; i < m_sinks.size(); ++i)
+        {
+            if (i < wanted.size() && wanted[i])
+            {
+                m_sinks[i]->on_syscall_exit(event);
+            }
+        }
+    }
+    event.entry_ns = 0;
+}
+
+void Tracer::log_syscall_entry(SyscallEvent &event, bool log)
+{
     auto info = Syscall::get_syscall_info(
-        regs.orig_rax); // O valor do id da chamada de sistema em x86-64 está no registrador 'rax'.
+        event.nr); // O valor do id da chamada de sistema em x86-64 está no registrador 'rax'.
     if (info)
     {
         std::string args_str;
-        long long vals[] = {
-            (long long)regs.rdi, (long long)regs.rsi, (long long)regs.rdx, (long long)regs.r10,
-            (long long)regs.r8,  (long long)regs.r9}; // Os 6 registradores de valor do Ptrace
+        const unsigned long long *vals = event.args;
+        // Buffers de dados são binários, então nunca são lidos como strings. São mostrados como
+        // a referência para o arquivo de payloads, quando capturados, ou como ponteiros.
+        const auto data_buffer = PayloadCapture::find_data_buffer(event.nr);
         if (!info->arg_types.empty())
         {
             for (int i = 0; i < info->arg_count; ++i)
             {
                 if (i > 0)
                     args_str += ", ";
-                args_str += format_argument(pid, info->arg_types[i], vals[i]);
+                if (data_buffer && data_buffer->buf_arg == i)
+                {
+                    args_str += event.payload_len
+                                    ? fmt::format("payload@{}:{}", event.payload_offset,
+                                                  event.payload_len)
+                                    : fmt::format("{:#x}", vals[i]);
+                    continue;
+                }
+                args_str += format_argument(event.tid, info->arg_types[i], (long long)vals[i]);
             }
         }
         else
@@ -289,30 +1142,29 @@ void Tracer::log_syscall_entry(pid_t pid)
                 args_str += fmt::format("{:#x}", vals[i]);
             }
         }
-        spdlog::info("SYSCALL_ENTRY [PID:{}] {}({})", pid, info->name, args_str);
+        event.args_str = std::move(args_str);
     }
     else
     {
-        spdlog::warn("SYSCALL_ENTRY [PID:{}] unknown {}", pid, regs.orig_rax);
+        event.args_str.clear();
+    }
+    if (log)
+    {
+        print_syscall_entry(event);
     }
 }
 
 /**
  * @brief Registra o resultado de uma chamada de sistema em seu ponto de saída.
- * @param pid O PID do processo cuja chamada está retornando.
+ * @param event O evento da chamada que está retornando.
  *
- * Lê o valor de retorno do registrador 'rax' e o registra no log.
+ * Registra no log o valor de retorno lido do registrador 'rax'.
  */
-void Tracer::log_syscall_exit(pid_t pid)
+void Tracer::log_syscall_exit(const SyscallEvent &event, bool entry_payload)
 {
-    user_regs_struct regs{};
-
-    ptrace(PTRACE_GETREGS, pid, nullptr, &regs);
+    const auto info = Syscall::get_syscall_info(event.nr);
 
-    const auto info =
-        Syscall::get_syscall_info(regs.orig_rax); // O número da syscall ainda está em 'orig_rax'.
-
-    auto ret = (long long)regs.rax; // O valor de retorno em x86-64 está no registrador 'rax'.
+    auto ret = event.ret;
     const char *name = info ? info->name.c_str() : "syscall";
 
     char buf[256];
@@ -328,5 +1180,15 @@ void Tracer::log_syscall_exit(pid_t pid)
     {
         snprintf(buf, sizeof(buf), "%lld", ret);
     }
-    spdlog::info("SYSCALL_EXIT  [PID:{}] {} = {}", pid, name, buf);
+    // Buffers capturados na saída (ou gravados só na saída) referenciam o trecho no arquivo de
+    // payloads.
+    const auto data_buffer = PayloadCapture::find_data_buffer(event.nr);
+    if (data_buffer && event.payload_len &&
+        (entry_payload || PayloadCapture::captures_at_exit(event, *data_buffer)))
+    {
+        spdlog::info("SYSCALL_EXIT  [PID:{}] {} = {} payload@{}:{}", event.tid, name, buf,
+                     event.payload_offset, event.payload_len);
+        return;
+    }
+    spdlog::info("SYSCALL_EXIT  [PID:{}] {} = {}", event.tid, name, buf);
 }
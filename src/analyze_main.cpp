@@ -0,0 +1,57 @@
+#include "TraceAnalyzer.h" // Header do projeto
+
+#include <chrono> // Usado para medir a vazão da análise.
+
+#include <cxxopts.hpp> // Usado para analisar os argumentos da linha de comando.
+
+#include <iostream> // Usado para imprimir a ajuda e o relatório na saída padrão (std::cout).
+
+#include <spdlog/sinks/stdout_color_sinks.h> // Usado para enviar o log para a saída de erro.
+
+#include <spdlog/spdlog.h> // Usado para registrar erros e o tempo da análise.
+
+#include <thread> // Usado pelo std::thread::hardware_concurrency.
+
+int main(int argc, char *argv[])
+{
+    // O log vai para a saída de erro, para que o relatório possa ser redirecionado sozinho.
+    spdlog::set_default_logger(spdlog::stderr_color_mt("analyze"));
+
+    cxxopts::Options options("TracerC-analyze", "Parallel analysis of TracerC --record files");
+    options.add_options()("j,jobs", "Worker threads (default: all cores)",
+                          cxxopts::value<unsigned>())(
+        "top", "Rows in the process and error tables",
+        cxxopts::value<std::size_t>()->default_value("20"))(
+        "file", "Recording to analyze", cxxopts::value<std::string>())("h,help", "Print help");
+    options.parse_positional({"file"});
+    options.positional_help("<recording>");
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help") || !result.count("file"))
+    {
+        std::cout << options.help() << std::endl;
+        return result.count("help") ? 0 : 1;
+    }
+
+    unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+    if (result.count("jobs"))
+    {
+        jobs = std::max(1u, result["jobs"].as<unsigned>());
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    TraceStats stats;
+    std::string error;
+    if (!TraceAnalyzer::analyze(result["file"].as<std::string>(), jobs, stats, error))
+    {
+        spdlog::critical("{}", error);
+        return 1;
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    spdlog::info("{} registros analisados em {:.3f}s com {} thread(s) ({:.1f} M registros/s)",
+                 stats.records, elapsed.count(), jobs,
+                 elapsed.count() > 0 ? stats.records / elapsed.count() / 1e6 : 0.0);
+
+    TraceAnalyzer::print_report(stats, result["top"].as<std::size_t>(), std::cout);
+    return 0;
+}
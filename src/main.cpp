@@ -1,26 +1,19 @@
-#include "Tracer.h" // Header do projeto
+#include "EventRingPublisher.h" // Header do projeto
+#include "Tracer.h"             // Header do projeto
 
 #include <cxxopts.hpp> // Usado para analisar os argumentos da linha de comando.
 
-#include <filesystem> // Usado para interagir com o sistema de arquivos, especificamente para navegar em /proc.
-
-#include <fstream> // Usado para ler arquivos, como o arquivo 'children' em /proc/[pid]/task/[tid]/.
+#include <iomanip> // Usado pelo std::put_time para formatar a data e hora do arquivo de log.
 
 #include <iostream> // Usado para imprimir a mensagem de ajuda na saída padrão (std::cout).
 
-#include <queue> // Usado pela função "find_all_related" para realizar uma busca em largura na árvore de processos.
-
-#include <set> // Usado para armazenar PIDs únicos e evitar o reprocessamento na busca de processos.
-
 #include <spdlog/sinks/basic_file_sink.h> // Usado para criar um sink do spdlog que redireciona a saída para um arquivo.
 
 #include <spdlog/sinks/stdout_color_sinks.h> // Usado para criar um sink do spdlog que redireciona a saída colorida para o console.
 
 #include <spdlog/spdlog.h> // Usado para a funcionalidade principal de logging com a biblioteca spdlog.
 
-#include <sys/ptrace.h> // Usado pela chamada de sistema ptrace para anexar e controlar outros processos.
-
-#include <sys/wait.h> // Usado pela função waitpid para aguardar por mudanças de estado nos processos filhos.
+#include <sstream> // Usado para montar o nome do arquivo de log.
 
 #include <vector> // Usado para armazenar a lista de argumentos do programa e os PIDs a serem rastreados.
 
@@ -28,8 +21,9 @@
  * @brief Configura o logger global spdlog para saída em arquivo e no console.
  * @details Inicializa um logger que escreve logs de nível `info` (e superiores) no console
  * e logs de nível "trace" (e superiores) em um arquivo com data e hora no diretório `logs/`.
+ * @return A data e hora usada no nome do arquivo, para nomear outros arquivos da mesma execução.
  */
-void setup_logger()
+std::string setup_logger()
 {
     // Bloco de código para configar o logger para criar os novos arquivos de logger na pasta
     // logs com o nome de trace-DATAATUAL.log
@@ -54,65 +48,48 @@ void setup_logger()
     logger.set_level(spdlog::level::trace);
     spdlog::set_default_logger(std::make_shared<spdlog::logger>(logger));
     spdlog::flush_on(spdlog::level::info);
-}
-
-/**
- * @brief Encontra todos os processos e threads descendentes de um determinado PID raiz.
- * @param root_pid O ID do processo a partir do qual a busca deve ser iniciada.
- * @return Um vetor contendo todos os PIDs e TIDs relacionados.
- */
-std::vector<pid_t> find_all_related(pid_t root_pid)
-{
-    // Bloco de código que inicializa o conjunto de pids relacionados a um pid
-    std::set<pid_t> pids;
-    std::queue<pid_t> q;
-    q.push(root_pid);
-
-    // Loop que vai percorrer procurar todos pids relacionados ao pid raiz
-    while (!q.empty())
-    {
-        pid_t current_pid = q.front();
-        q.pop();
-        std::string task_path = "/proc/" + std::to_string(current_pid) + "/task";
-        if (!std::filesystem::exists(task_path))
-        {
-            continue;
-        }
-
-        // Para o processo atual, itera sobre suas threads em /proc/[pid]/task.
-        // Adiciona o ID de cada thread (TID) à lista e verifica se a thread possui
-        // processos filhos, adicionando-os à fila de busca se ainda não foram vistos.
-        for (const auto &entry : std::filesystem::directory_iterator(task_path))
-        {
-            pid_t tid = std::stoi(entry.path().filename().string());
-            pids.insert(tid);
-            std::string children_path = entry.path().string() + "/children";
-            std::ifstream children_file(children_path);
-            pid_t child_pid;
-            while (children_file >> child_pid)
-            {
-                if (pids.find(child_pid) == pids.end())
-                {
-                    q.push(child_pid);
-                }
-            }
-        }
-    }
-
-    // Converte o conjunto de PIDs em um vetor e o retorna.
-    return {pids.begin(), pids.end()};
+    return ss.str();
 }
 
 int main(int argc, char *argv[])
 {
-    setup_logger(); // Configurar o logger
+    const std::string run_stamp = setup_logger(); // Configurar o logger
 
     // Bloco de código que configurar o cxxopts e as opções do programa, -h (ajuda), -a/-attach
     // (anexar), -f/-fork/nenhum (forkear)
     cxxopts::Options options("TracerC", "C++ ptrace-based syscall tracer");
     options.add_options()("a,attach", "PID to attach to", cxxopts::value<pid_t>())(
-        "f,fork", "Program to fork+trace",
-        cxxopts::value<std::vector<std::string>>())("h,help", "Print help");
+        "f,fork", "Program to fork+trace", cxxopts::value<std::vector<std::string>>())(
+        "blocked-report", "Report per-thread blocked time and the N longest blocking calls",
+        cxxopts::value<std::size_t>())(
+        "futex-report", "Report the N most contended futex addresses and the N longest waiters",
+        cxxopts::value<std::size_t>())(
+        "process-tree", "Profile the process tree: critical path and the N slowest subtrees",
+        cxxopts::value<std::size_t>())(
+        "capture-data", "Copy read/write buffers to a payload file (<syscalls>:<max-bytes>)",
+        cxxopts::value<std::string>())(
+        "metrics-listen", "Serve OpenMetrics counters on <unix-socket|127.0.0.1:port>",
+        cxxopts::value<std::string>())(
+        "timeline", "Write a Perfetto (or Chrome JSON, if *.json) timeline to <file>",
+        cxxopts::value<std::string>())(
+        "advise", "Report inefficient syscall patterns with example call sites")(
+        "record", "Record every syscall to a binary <file> for TracerC-analyze",
+        cxxopts::value<std::string>())(
+        "memory-profile", "Write per-process anonymous/file virtual memory over time to <file>.csv",
+        cxxopts::value<std::string>())(
+        "shm-ring", "Publish every event to a shared-memory ring /dev/shm/<name>[:<slots>]",
+        cxxopts::value<std::string>())(
+        "overhead-budget",
+        "Narrow tracing when ptrace stops exceed <N>[,sample] per second. With ',sample', busy "
+        "threads are also sampled; that stops them once per second, which can make epoll_wait, "
+        "semop or sigtimedwait return EINTR",
+        cxxopts::value<std::string>())(
+        "control", "Accept pause/resume/filter/add/remove/detach commands on a unix socket",
+        cxxopts::value<std::string>())(
+        "filter", "Only trace events matching <expr>, e.g. 'pid in {12,13} && ret < 0'",
+        cxxopts::value<std::string>())(
+        "syscalls", "Only trace the given comma-separated syscalls",
+        cxxopts::value<std::string>())("h,help", "Print help");
     options.parse_positional({"fork"});
     options.positional_help("<program> [args...]");
     auto result = options.parse(argc, argv);
@@ -124,54 +101,143 @@ int main(int argc, char *argv[])
         return 0;
     }
 
-    if (result.count("attach"))
+    // Bloco de código que converte as opções de análise em TracerOptions
+    TracerOptions tracer_options;
+    if (result.count("blocked-report"))
+    {
+        tracer_options.blocked_report_top = result["blocked-report"].as<std::size_t>();
+    }
+    if (result.count("futex-report"))
+    {
+        tracer_options.futex_report_top = result["futex-report"].as<std::size_t>();
+    }
+    if (result.count("process-tree"))
+    {
+        tracer_options.process_tree_top = result["process-tree"].as<std::size_t>();
+    }
+    if (result.count("capture-data"))
+    {
+        std::string error;
+        if (!PayloadCapture::parse_spec(result["capture-data"].as<std::string>(),
+                                        tracer_options.capture_syscalls,
+                                        tracer_options.capture_max_bytes, error))
+        {
+            spdlog::critical("--capture-data inválido: {}", error);
+            return 1;
+        }
+        tracer_options.capture_path = "logs/payload-" + run_stamp + ".bin";
+    }
+    if (result.count("metrics-listen"))
+    {
+        tracer_options.metrics_listen = result["metrics-listen"].as<std::string>();
+    }
+    if (result.count("timeline"))
+    {
+        tracer_options.timeline_path = result["timeline"].as<std::string>();
+    }
+    if (result.count("advise"))
+    {
+        tracer_options.advise = true;
+    }
+    if (result.count("record"))
     {
+        tracer_options.record_path = result["record"].as<std::string>();
+    }
+    if (result.count("memory-profile"))
+    {
+        tracer_options.memory_profile_path = result["memory-profile"].as<std::string>();
+    }
+    // O anel é criado aqui, antes do attach ou do fork: um anel que não pode ser criado deixaria
+    // os leitores esperando para sempre, então a falha encerra o TracerC antes de parar qualquer
+    // processo.
+    std::unique_ptr<EventRingPublisher> ring;
+    if (result.count("shm-ring"))
+    {
+        std::string error;
+        std::string ring_name;
+        std::uint32_t ring_slots = 0;
+        if (!EventRingPublisher::parse_spec(result["shm-ring"].as<std::string>(), ring_name,
+                                            ring_slots, error))
+        {
+            spdlog::critical("--shm-ring inválido: {}", error);
+            return 1;
+        }
+        ring = std::make_unique<EventRingPublisher>(ring_name, ring_slots);
+        if (!ring->valid())
+        {
+            spdlog::critical("--shm-ring: não foi possível criar o anel de eventos");
+            return 1;
+        }
+    }
+    if (result.count("overhead-budget"))
+    {
+        std::string error;
+        if (!OverheadGovernor::parse_spec(result["overhead-budget"].as<std::string>(),
+                                          tracer_options.overhead_budget,
+                                          tracer_options.overhead_sampling, error))
+        {
+            spdlog::critical("--overhead-budget inválido: {}", error);
+            return 1;
+        }
+    }
+    if (result.count("control"))
+    {
+        tracer_options.control_path = result["control"].as<std::string>();
+    }
+    if (result.count("filter"))
+    {
+        std::string error;
+        tracer_options.filter = FilterProgram::compile(result["filter"].as<std::string>(), error);
+        if (!tracer_options.filter)
+        {
+            spdlog::critical("--filter inválido: {}", error);
+            return 1;
+        }
+    }
+    if (result.count("syscalls"))
+    {
+        tracer_options.syscall_filter = result["syscalls"].as<std::string>();
+    }
+    // O perfil da árvore só usa eventos de processo; sem o log de cada syscall, as threads rodam
+    // sem paradas de syscall se nenhuma outra análise precisar delas. --syscalls, --filter e
+    // --control só fazem sentido com o log, então ele é mantido se algum deles foi passado.
+    if (result.count("process-tree") && !result.count("syscalls") && !result.count("filter") &&
+        !result.count("control"))
+    {
+        tracer_options.log_syscalls = false;
+        spdlog::info("--process-tree: log de syscalls desativado (use --syscalls para mantê-lo)");
+    }
 
-        pid_t root_pid = result["attach"].as<pid_t>();
-        std::vector<pid_t> pids_to_trace =
-            find_all_related(root_pid); // Cria um vetor de pids para escutar
+    if (result.count("attach"))
+    {
+        // Anexa o processo e todos os seus descendentes, que ficam parados até o run()
+        std::vector<pid_t> pids_to_trace = attach_tree(result["attach"].as<pid_t>());
         if (pids_to_trace.empty())
         {
             spdlog::critical("Não foi possível encontrar nenhum processo para escutar!");
             return 0;
         }
 
-        // Loop para configurar o ptrace de cada um dos pids a serem escutados
-        for (pid_t pid : pids_to_trace)
-        {
-            if (ptrace(PTRACE_ATTACH, pid, nullptr, nullptr) ==
-                -1) // Inicializa o Ptrace no pid atual
-            {
-                spdlog::warn("Attach do processo {} falhou: {}", pid, strerror(errno));
-                continue;
-            }
-            waitpid(pid, nullptr, 0); // Espera o processo entrar no processo SIGSTOP por conta do
-                                      // PTRACE_ATTACH anterior, basicamente esperando que a
-                                      // anexação foi concluída antes de continuar com a lógica
-            ptrace(PTRACE_SETOPTIONS, pid, nullptr,
-                   PTRACE_O_TRACESYSGOOD | PTRACE_O_TRACECLONE | PTRACE_O_TRACEFORK |
-                       PTRACE_O_TRACEVFORK |
-                       PTRACE_O_TRACEEXEC); // Setar as configurações do ptrace, basicamente fazendo
-                                            // ele escutar chamadas de sistema, clones, forks,
-                                            // vforks, execs e mortes
-        }
-
-        Tracer tracer(pids_to_trace); // Cria um objeto tracer passando os pids a serem escutados
-
-        // Inicializar o ptrace para a proxima chamada de sistema em cada um dos pids a serem
-        // escutados
-        for (pid_t pid : pids_to_trace)
+        // Cria um objeto tracer passando os pids a serem escutados
+        Tracer tracer(pids_to_trace, tracer_options);
+        if (ring)
         {
-            ptrace(PTRACE_SYSCALL, pid, nullptr, nullptr);
+            tracer.add_sink(std::move(ring));
         }
-
         tracer.run(); // Começar loop do objeto tracer
     }
     else if (result.count("fork"))
     {
         auto args = result["fork"].as<std::vector<std::string>>();
-        fork_and_trace(args); // Chamar função static fork_and_trace da classe Tracer passando o
-                              // vetor de strings (para lidar com coisas do tipo Python3 ~/main.py)
+        // Cria o filho passando o vetor de strings (para lidar com coisas do tipo
+        // Python3 ~/main.py), como o fork_and_trace, mas registrando o anel já criado.
+        std::vector<pid_t> pids_to_trace = {spawn_traced(args)};
+        Tracer tracer(pids_to_trace, tracer_options);
+        if (ring)
+        {
+            tracer.add_sink(std::move(ring));
+        }
+        tracer.run();
     }
     spdlog::shutdown();
     return 0;